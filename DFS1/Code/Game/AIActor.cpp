@@ -3,11 +3,10 @@
 #include "Game/Player.hpp"
 #include "Game/Game.hpp"
 #include "Game/Map.hpp"
+#include "Game/NavSnapshot.hpp"
 #include "Game/App.hpp"
 #include "Game/ActorDefinitions.hpp"
 #include "Game/Weapon.hpp"
-#include "Engine/Core/Clock.hpp"
-#include "Engine/Core/Timer.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/DebugRenderer.hpp"
@@ -26,10 +25,10 @@ AIActor::AIActor(Game* game, Map* map)
 {
 	m_currentState = AIState::PATROL;
 
-	g_rng.SetSeed(GetRandomSeedFromTime());
+	// Agents are created in a fixed order, so seeding each one's generator from the global one keeps a run repeatable
+	m_rng.SetSeed(static_cast<unsigned int>(g_rng.SRollRandomIntInRange(0, 0x3FFFFFFF)));
 	m_repathPeriod = g_rng.RollRandomFloatInRange(2.5f, 4.5f);
-	m_repathTimer = Timer(m_repathPeriod, g_theApp->m_game->m_clock);
-	m_repathTimer.Start();
+	m_nextRepathSeconds = m_currentMap->m_timers.GetElapsedSeconds() + m_repathPeriod;
 }
 
 void AIActor::DamagedBy(Actor* actor)
@@ -42,60 +41,118 @@ void AIActor::DamagedBy(Actor* actor)
 
 void AIActor::Update()
 {
+	Think();
+	ApplyCommands();
+}
+
+void AIActor::Think()
+{
+	// Only this agent and its own actor are written here, so the map can run many agents at once.
+	// Anything that touches other actors or shared map state is queued for ApplyCommands
  	m_actor = m_currentMap->GetActorByUID(m_actorUID);
  	IntVec2 startPos = m_currentMap->GetTileCoordsForPos(GetActor()->m_position);
 	m_aiStartPos = startPos;
 
 	if (m_currentMap->m_hasPlayerReachedGoal) return;
 
-	switch (m_currentState)
+	// Sleeping agents skip everything, mid range agents keep steering every frame but only think every few frames
+	if (m_lodTier == AILODTier::FAR) return;
+
+	if (m_isThinkingThisFrame)
 	{
-	case AIState::PATROL:
-		m_movementSpeed = m_actor->m_walkSpeed;
-		m_aiExteriorSenseColor = Rgba8::GREEN;
-		m_aiInteriorSenseColor = Rgba8::TRANSLUCENT_GREEN;
-		g_rng.SetSeed(GetRandomSeedFromTime());
-		m_patrolRange = g_rng.SRollRandomIntInRange(2, 10);
-		PatrolArea(m_patrolRange, startPos);
-		break;
-	case AIState::CHASE:
-		m_movementSpeed = m_actor->m_runSpeed;
-		m_aiExteriorSenseColor = Rgba8::RED;
-		m_aiInteriorSenseColor = Rgba8::TRANSLUCENT_RED;
-		ChaseTarget();
-		break;
+		RespondToSquadAlert();
+
+		switch (m_currentState)
+		{
+		case AIState::PATROL:
+			m_movementSpeed = m_actor->m_walkSpeed;
+			m_aiExteriorSenseColor = Rgba8::GREEN;
+			m_aiInteriorSenseColor = Rgba8::TRANSLUCENT_GREEN;
+			m_patrolRange = m_rng.SRollRandomIntInRange(2, 10);
+			PatrolArea(m_patrolRange, startPos);
+			break;
+		case AIState::CHASE:
+			m_movementSpeed = m_actor->m_runSpeed;
+			m_aiExteriorSenseColor = Rgba8::RED;
+			m_aiInteriorSenseColor = Rgba8::TRANSLUCENT_RED;
+			ChaseTarget();
+			break;
+		case AIState::SEARCH:
+			m_movementSpeed = m_actor->m_walkSpeed;
+			m_aiExteriorSenseColor = Rgba8::YELLOW;
+			m_aiInteriorSenseColor = Rgba8::TRANSLUCENT_YELLOW;
+			SearchArea(startPos);
+			break;
+		}
 	}
 
-	while (true)
+	AStarUpdate();
+}
+
+void AIActor::ApplyCommands()
+{
+	if (m_isPathCacheTouchQueued)
 	{
-		Job* completedJob = g_theJobSystem->RetrieveCompletedJob();
-		if (!completedJob) break;
+		m_currentMap->m_pathCache->MarkUsed(m_queuedPathCacheKey);
+		m_isPathCacheTouchQueued = false;
+	}
 
-		AStarPathfindingJob* pathingJob = dynamic_cast<AStarPathfindingJob*>(completedJob);
-		if (!pathingJob)
+	if (m_hasQueuedPathRequest)
+	{
+		if (m_currentMap->m_isBatchingPathRequests)
+		{
+			m_currentMap->m_pendingPathRequests.push_back(m_queuedPathRequest);
+		}
+		else
 		{
-			delete completedJob;
-			continue;
+			AStarPathfindingJob* job = new AStarPathfindingJob(m_queuedPathRequest, m_currentMap->m_navSnapshot, m_currentMap->m_pathCache);
+			g_theJobSystem->QueueJob(job);
 		}
+		m_hasQueuedPathRequest = false;
+	}
 
-		// Ensure the AI who requested this job gets the path
-		pathingJob->m_ai->m_aiPath = pathingJob->GetResult();
-		pathingJob->m_ai->m_isWaitingForPath = false;
-		delete pathingJob;
+	if (m_isAttackQueued)
+	{
+		m_actor->Attack();
+		m_isAttackQueued = false;
 	}
 
-	AStarUpdate();
+	if (m_isAlertQueued)
+	{
+		Actor* playerActor = m_currentMap->GetPlayerActor();
+		if (playerActor != nullptr)
+		{
+			AlertOtherAiAgents(playerActor);
+		}
+		m_isAlertQueued = false;
+	}
+
+	if (m_isStandDownQueued)
+	{
+		StandDownSquad();
+		m_isStandDownQueued = false;
+	}
+
+	ApplyCountdownCommands();
+
+	if (m_currentMap->m_hasPlayerReachedGoal || m_lodTier == AILODTier::FAR || !m_isThinkingThisFrame) return;
  
 	if (m_currentGame->m_player->m_isShowingDebugOptions)
 	{
 		DebugCurrentAIPath();
 		DebugCurrentAIGoalPosition();
 	}
+
+	RenderSnapshot& snapshot = m_currentMap->GetBuildingSnapshot();
+	if (m_currentMap->m_isBatchingPerception && m_perceptionIndex >= 0 && m_currentMap->m_perception.WasRayCast(m_perceptionIndex))
+	{
+		snapshot.AddDebugWorldLine(GetActor()->GetModelMatrix(), m_currentMap->m_perception.GetRayLength(m_perceptionIndex), 0.1f, 32, 0.f, m_aiExteriorSenseColor, m_aiExteriorSenseColor, DebugRenderMode::ALWAYS);
+	}
  
 	Vec3 enemyActorPos = m_actor->m_position + Vec3(0.f, 0.f, m_actor->m_eyeHeight);
-	DebugAddWorld3DRing(enemyActorPos, m_sensorRadius, 16, 0.25f, 0.f, m_aiExteriorSenseColor, m_aiExteriorSenseColor, DebugRenderMode::ALWAYS);
-	DebugAddWorld3DTriangle(m_actor->GetModelMatrix(), m_actor->m_orientation.GetForwardVector(), m_actor->m_eyeHeight, m_sightDistance, 0.f, m_aiInteriorSenseColor, m_aiInteriorSenseColor, DebugRenderMode::ALWAYS);
-	DebugAddWorld3DWireTriangle(m_actor->GetModelMatrix(), m_actor->m_orientation.GetForwardVector(), m_actor->m_eyeHeight, m_sightDistance, 0.f, m_aiExteriorSenseColor, m_aiExteriorSenseColor, DebugRenderMode::ALWAYS);
+	snapshot.AddDebugWorld3DRing(enemyActorPos, m_sensorRadius, 16, 0.25f, 0.f, m_aiExteriorSenseColor, m_aiExteriorSenseColor, DebugRenderMode::ALWAYS);
+	snapshot.AddDebugWorld3DTriangle(m_actor->GetModelMatrix(), m_actor->m_orientation.GetForwardVector(), m_actor->m_eyeHeight, m_sightDistance, 0.f, m_aiInteriorSenseColor, m_aiInteriorSenseColor, DebugRenderMode::ALWAYS, false);
+	snapshot.AddDebugWorld3DTriangle(m_actor->GetModelMatrix(), m_actor->m_orientation.GetForwardVector(), m_actor->m_eyeHeight, m_sightDistance, 0.f, m_aiExteriorSenseColor, m_aiExteriorSenseColor, DebugRenderMode::ALWAYS, true);
 }
 
 void AIActor::AStarUpdate()
@@ -111,7 +168,7 @@ void AIActor::AStarUpdate()
 		Vec3 directionToTarget = nextTileCenter - m_actor->m_position;
 
 		float turnTowards = directionToTarget.GetAngleAboutZDegrees();
-		float maxturnAngle = m_actor->m_turnSpeed * m_currentGame->m_clock->GetDeltaSeconds();
+		float maxturnAngle = m_actor->m_turnSpeed * m_currentMap->GetStepDeltaSeconds();
 
 		m_actor->TurnInDirection(turnTowards, maxturnAngle);
 		m_actor->MoveInDirection(directionToTarget, m_movementSpeed);
@@ -132,14 +189,15 @@ void AIActor::DebugCurrentAIPath() const
 	{
 		if (!m_aiPath.empty())
 		{
+			RenderSnapshot& snapshot = m_currentMap->GetBuildingSnapshot();
 			for (int i = 0; i < m_aiPath.size(); i++)
 			{
 				Vec3 pbottomLeft = Vec3((float)m_aiPath[i].x - 0.5f, (float)m_aiPath[i].y - 0.5f, 0.1f);
 				Vec3 pbottomRight = Vec3((float)m_aiPath[i].x + 0.5f, (float)m_aiPath[i].y - 0.5f, 0.1f);
 				Vec3 ptopRight = Vec3((float)m_aiPath[i].x + 0.5f, (float)m_aiPath[i].y + 0.5f, 0.1f);
 				Vec3 ptopLeft = Vec3((float)m_aiPath[i].x - 0.5f, (float)m_aiPath[i].y + 0.5f, 0.1f);
-				DebugAddWorldQuad(0.f, pbottomLeft, pbottomRight, ptopRight, ptopLeft, Rgba8::GREEN, Rgba8::GREEN, DebugRenderMode::USE_DEPTH);
-				DebugAddWorldWireQuad(0.f, pbottomLeft, pbottomRight, ptopRight, ptopLeft, Rgba8::WHITE, Rgba8::WHITE, DebugRenderMode::USE_DEPTH);
+				snapshot.AddDebugWorldQuad(0.f, pbottomLeft, pbottomRight, ptopRight, ptopLeft, Rgba8::GREEN, Rgba8::GREEN, DebugRenderMode::USE_DEPTH, false);
+				snapshot.AddDebugWorldQuad(0.f, pbottomLeft, pbottomRight, ptopRight, ptopLeft, Rgba8::WHITE, Rgba8::WHITE, DebugRenderMode::USE_DEPTH, true);
 			}
 		}
 	}
@@ -153,8 +211,9 @@ void AIActor::DebugCurrentAIGoalPosition() const
 		Vec3 obottomRight = Vec3((float)m_storedGoalPosition.x + 0.5f, (float)m_storedGoalPosition.y - 0.5f, 0.1f);
 		Vec3 otopRight = Vec3((float)m_storedGoalPosition.x + 0.5f, (float)m_storedGoalPosition.y + 0.5f, 0.1f);
 		Vec3 otopLeft = Vec3((float)m_storedGoalPosition.x - 0.5f, (float)m_storedGoalPosition.y + 0.5f, 0.1f);
-		DebugAddWorldQuad(m_repathTimer.m_period, obottomLeft, obottomRight, otopRight, otopLeft, Rgba8::PURPLE, Rgba8::PURPLE, DebugRenderMode::USE_DEPTH);
-		DebugAddWorldWireQuad(m_repathTimer.m_period, obottomLeft, obottomRight, otopRight, otopLeft, Rgba8::WHITE, Rgba8::WHITE, DebugRenderMode::USE_DEPTH);
+		RenderSnapshot& snapshot = m_currentMap->GetBuildingSnapshot();
+		snapshot.AddDebugWorldQuad(m_repathPeriod, obottomLeft, obottomRight, otopRight, otopLeft, Rgba8::PURPLE, Rgba8::PURPLE, DebugRenderMode::USE_DEPTH, false);
+		snapshot.AddDebugWorldQuad(m_repathPeriod, obottomLeft, obottomRight, otopRight, otopLeft, Rgba8::WHITE, Rgba8::WHITE, DebugRenderMode::USE_DEPTH, true);
 	}
 }
 
@@ -162,11 +221,55 @@ void AIActor::RequestPathfindingJob(IntVec2 startPoint, IntVec2 goalPoint)
 {
 	if (m_isWaitingForPath) return;
 
-	AStarPathfindingJob* job = new AStarPathfindingJob(this, startPoint, goalPoint, m_currentMap->GetMapDimensions());
-	g_theJobSystem->QueueJob(job);
+	// Patrol routes keep asking for the same few tiles, so serve those straight from the cache
+	// The lookup leaves the cache's recency order alone, the entry is marked used in ApplyCommands so the order only depends on actor order
+	if (m_currentMap->m_pathCache->TryGetPath(startPoint, goalPoint, m_pathDirectionMode, m_currentMap->m_navSnapshot->GetNavigationMode(m_pathDirectionMode), m_aiPath, &m_queuedPathCacheKey))
+	{
+		m_isPathCacheTouchQueued = true;
+		if (m_currentMap->m_isSmoothingPaths)
+		{
+			m_currentMap->m_navSnapshot->SmoothPath(startPoint, m_aiPath, m_actor->m_physicsRadius);
+		}
+		return;
+	}
+
+	PathRequest request;
+	request.m_aiUID = m_actorUID;
+	request.m_start = startPoint;
+	request.m_goal = goalPoint;
+	SubmitPathRequest(request);
+}
+
+void AIActor::RequestPathToNearestTarget(IntVec2 startPoint, const std::vector<IntVec2>& targets)
+{
+	if (m_isWaitingForPath || targets.empty()) return;
+
+	// The nearest target is not known up front so there is nothing to look up in the path cache
+	PathRequest request;
+	request.m_aiUID = m_actorUID;
+	request.m_start = startPoint;
+	request.m_goals = targets;
+	SubmitPathRequest(request);
+}
+
+void AIActor::SubmitPathRequest(PathRequest& request)
+{
+	request.m_directionMode = m_pathDirectionMode;
+	request.m_isSmoothingPath = m_currentMap->m_isSmoothingPaths;
+	request.m_agentRadius = m_actor->m_physicsRadius;
+
+	// Handed to the map in ApplyCommands, which keeps the batch in actor order however the agents were split across threads
+	m_queuedPathRequest = request;
+	m_hasQueuedPathRequest = true;
 	m_isWaitingForPath = true;
 }
 
+void AIActor::ReceivePath(const IntVec2* waypoints, size_t numWaypoints)
+{
+	m_aiPath.assign(waypoints, waypoints + numWaypoints);
+	m_isWaitingForPath = false;
+}
+
 void AIActor::PatrolArea(int patrolRange, IntVec2 startPos)
 {
 	Actor* targetActor = g_theApp->m_game->m_currentMap->GetPlayerActor();
@@ -177,13 +280,19 @@ void AIActor::PatrolArea(int patrolRange, IntVec2 startPos)
 
 	if (!CanSeeTarget(targetActor))
 	{
+		if (!m_currentMap->m_patrolNetwork.IsEmpty())
+		{
+			FollowPatrolNetwork(startPos);
+			return;
+		}
+
 		IntVec2 currnetGoalPos = startPos;
 		bool hasReachedGoal = true;
 
-		if (hasReachedGoal && m_repathTimer.HasPeriodElapsed())
+		if (hasReachedGoal && IsRepathDue())
 		{
 			// Get random goal tile position within patrol range 
-			currnetGoalPos = m_currentMap->GetRandomTilewithinRange(startPos, patrolRange);
+			currnetGoalPos = m_currentMap->GetRandomTilewithinRange(startPos, patrolRange, m_rng);
 			m_storedGoalPosition = currnetGoalPos;
 			if (!m_currentMap->IsSolidTile(currnetGoalPos.x, currnetGoalPos.y))
 			{
@@ -191,7 +300,7 @@ void AIActor::PatrolArea(int patrolRange, IntVec2 startPos)
 			}
 
 			// Reset timer
-			m_repathTimer.DecrementPeriodIfElapsed();
+			m_nextRepathSeconds += m_repathPeriod;
 			hasReachedGoal = false;
 		}
 
@@ -208,14 +317,136 @@ void AIActor::PatrolArea(int patrolRange, IntVec2 startPos)
 	}
 }
 
+void AIActor::FollowPatrolNetwork(IntVec2 startPos)
+{
+	if (!m_aiPath.empty() || m_isWaitingForPath)
+	{
+		return;
+	}
+
+	const PatrolNetwork& patrolNetwork = m_currentMap->m_patrolNetwork;
+	int waypointHere = patrolNetwork.GetWaypointAtTile(startPos);
+	if (waypointHere < 0)
+	{
+		// Coming back from a chase or search, or pushed off the route; this is the only time patrol pathfinds.
+		// A single search against every waypoint finds whichever is closest by path, not by straight line
+		if (!IsRepathDue())
+		{
+			return;
+		}
+		m_nextRepathSeconds += m_repathPeriod;
+
+		m_patrolWaypoint = -1;
+		m_previousPatrolWaypoint = -1;
+		RequestPathToNearestTarget(startPos, patrolNetwork.GetWaypoints());
+		return;
+	}
+
+	if (waypointHere != m_patrolWaypoint)
+	{
+		m_previousPatrolWaypoint = -1;
+	}
+	m_patrolWaypoint = waypointHere;
+
+	const PatrolEdge* patrolEdge = patrolNetwork.ChooseNextEdge(m_patrolWaypoint, m_previousPatrolWaypoint, m_rng);
+	if (patrolEdge == nullptr)
+	{
+		return;
+	}
+
+	m_aiPath = patrolEdge->m_path;
+	if (m_currentMap->m_isSmoothingPaths)
+	{
+		m_currentMap->m_navSnapshot->SmoothPath(startPos, m_aiPath, m_actor->m_physicsRadius);
+	}
+	m_previousPatrolWaypoint = m_patrolWaypoint;
+	m_patrolWaypoint = patrolEdge->m_toWaypoint;
+	m_storedGoalPosition = patrolNetwork.GetWaypointCoords(m_patrolWaypoint);
+}
+
+void AIActor::SearchArea(IntVec2 startPos)
+{
+	Actor* targetActor = m_currentMap->GetPlayerActor();
+	if (targetActor == nullptr)
+	{
+		return;
+	}
+
+	if (CanSeeTarget(targetActor))
+	{
+		m_currentState = AIState::CHASE;
+		return;
+	}
+
+	if (HasCountdownExpired(m_searchCountdown))
+	{
+		m_currentState = AIState::PATROL;
+		return;
+	}
+
+	if (IsRepathDue())
+	{
+		// Head for wherever the player most likely went, or wander like a patrol once the trail has gone cold
+		IntVec2 searchGoalPos = startPos;
+		if (!m_currentMap->m_influenceMap.SampleSearchGoal(startPos, m_searchRadius, m_rng, searchGoalPos))
+		{
+			searchGoalPos = m_currentMap->GetRandomTilewithinRange(startPos, m_searchRadius, m_rng);
+		}
+
+		m_storedGoalPosition = searchGoalPos;
+		if (searchGoalPos != startPos && !m_currentMap->IsSolidTile(searchGoalPos.x, searchGoalPos.y))
+		{
+			RequestPathfindingJob(startPos, searchGoalPos);
+		}
+		m_nextRepathSeconds += m_repathPeriod;
+	}
+}
+
+bool AIActor::IsRepathDue() const
+{
+	return m_currentMap->m_timers.GetElapsedSeconds() >= m_nextRepathSeconds;
+}
+
+void AIActor::EnterSearchState()
+{
+	m_currentState = AIState::SEARCH;
+	ResetCountdown(m_searchCountdown);
+}
+
 bool AIActor::CanSeeTarget(Actor* playerActor)
 {
-	FindTargetWithinLineOfSight(playerActor, m_sightDistance, m_sightFOV);
+	if (m_currentMap->m_isBatchingPerception && m_perceptionIndex >= 0)
+	{
+		// The map's perception pass has already tested every AI against the player this frame
+		const PerceptionSystem& perception = m_currentMap->m_perception;
+		if (perception.CanSeePlayer(m_perceptionIndex))
+		{
+			m_detectedActor = m_currentMap->GetPlayerActor();
+		}
+	}
+	else
+	{
+		// Patrol, the lost-sight checks and teammates can all ask within one frame, only the first asker casts rays
+		Actor* targetActor = m_currentMap->GetPlayerActor();
+		bool isVisible = false;
+		if (targetActor && m_currentMap->m_visibilityCache.TryGetVisibility(m_actorUID, targetActor->GetUID(), isVisible))
+		{
+			if (isVisible)
+			{
+				m_detectedActor = targetActor;
+			}
+		}
+		else if (targetActor)
+		{
+			isVisible = FindTargetWithinLineOfSight(playerActor, m_sightDistance, m_sightFOV);
+			m_currentMap->m_visibilityCache.StoreVisibility(m_actorUID, targetActor->GetUID(), isVisible);
+		}
+	}
 	if (m_detectedActor || m_HasBeenAlertedByTeammate) return true;
 	return false;
 }
 
-void AIActor::FindTargetWithinLineOfSight(Actor* playerActor, float distance, float angle)
+bool AIActor::FindTargetWithinLineOfSight(Actor* playerActor, float distance, float angle)
 {
 	m_actor = m_currentMap->GetActorByUID(m_actorUID);
 	Vec3 eyePos = m_actor->m_position + Vec3(0.f, 0.f, m_actor->m_eyeHeight);
@@ -240,36 +471,42 @@ void AIActor::FindTargetWithinLineOfSight(Actor* playerActor, float distance, fl
 
 	if (playerDistance <= distance)
 	{
-		if (fabsf(deltAngle) <= angle)
+		// Tile pairs the visibility set rules out would only have the ray stop on a wall
+		IntVec2 eyeTile = m_currentMap->GetTileCoordsForPos(eyePos);
+		IntVec2 playerTile = m_currentMap->GetTileCoordsForPos(playerActor->m_position);
+		if (fabsf(deltAngle) <= angle && m_currentMap->m_tileVisibility.IsPotentiallyVisible(eyeTile, playerTile))
 		{
 			RaycastResult raycastResult = m_currentMap->RaycastAll(m_actor, eyePos, displacement, distance);
-			DebugAddWorldLine(GetActor()->GetModelMatrix(), raycastResult.m_impactDist, 0.1f, 32, 0.f, m_aiExteriorSenseColor, m_aiExteriorSenseColor, DebugRenderMode::ALWAYS);
+			m_currentMap->GetBuildingSnapshot().AddDebugWorldLine(GetActor()->GetModelMatrix(), raycastResult.m_impactDist, 0.1f, 32, 0.f, m_aiExteriorSenseColor, m_aiExteriorSenseColor, DebugRenderMode::ALWAYS);
 			if (raycastResult.m_didImpact && raycastResult.m_impactedActor && raycastResult.m_impactedActor->IsPlayer())
 			{
 				m_detectedActor = playerActor;
-				return;
+				return true;
 			}
 		}
 	}
 
-	FindTargetWithinSensorRadius(playerActor, playerDistance);
+	return FindTargetWithinSensorRadius(playerActor, playerDistance);
 }
 
-void AIActor::FindTargetWithinSensorRadius(Actor* playerActor, float playerDistance)
+bool AIActor::FindTargetWithinSensorRadius(Actor* playerActor, float playerDistance)
 {
 	Vec3 eyePos = m_actor->m_position + Vec3(0.f, 0.f, m_actor->m_eyeHeight);
 	Vec3 displacement = (playerActor->m_position - m_actor->m_position).GetNormalized();
 
-	if (playerDistance <= m_sensorRadius)
+	IntVec2 eyeTile = m_currentMap->GetTileCoordsForPos(eyePos);
+	IntVec2 playerTile = m_currentMap->GetTileCoordsForPos(playerActor->m_position);
+	if (playerDistance <= m_sensorRadius && m_currentMap->m_tileVisibility.IsPotentiallyVisible(eyeTile, playerTile))
 	{
 		RaycastResult raycastResult = m_currentMap->RaycastAll(m_actor, eyePos, displacement, m_sensorRadius);
-		DebugAddWorldLine(GetActor()->GetModelMatrix(), raycastResult.m_impactDist, 0.1f, 32, 0.f, m_aiExteriorSenseColor, m_aiExteriorSenseColor, DebugRenderMode::ALWAYS);
+		m_currentMap->GetBuildingSnapshot().AddDebugWorldLine(GetActor()->GetModelMatrix(), raycastResult.m_impactDist, 0.1f, 32, 0.f, m_aiExteriorSenseColor, m_aiExteriorSenseColor, DebugRenderMode::ALWAYS);
 		if (raycastResult.m_didImpact && raycastResult.m_impactedActor && raycastResult.m_impactedActor->IsPlayer())
 		{
 			m_detectedActor = playerActor;
-			return;
+			return true;
 		}
 	}
+	return false;
 }
 
 void AIActor::ChaseTarget()
@@ -285,12 +522,11 @@ void AIActor::ChaseTarget()
 
 	if (!HasLostSightOfTarget(targetActor, m_sightDistance, m_sensorRadius))
 	{
-		m_alertTeammatesTimer -= m_currentGame->m_clock->GetDeltaSeconds();
-		if (m_alertTeammatesTimer <= 0.f)
+		if (HasCountdownExpired(m_alertTeammatesCountdown))
 		{
 			m_didAlertTeammates = true;
-			AlertOtherAiAgents(targetActor);
-			m_alertTeammatesTimer = m_resetAlertTimer;
+			m_isAlertQueued = true;
+			ResetCountdown(m_alertTeammatesCountdown);
 		}
 
 		if (m_currentTargetTileCoords != m_lastKnownTargetTileCoords)
@@ -300,24 +536,22 @@ void AIActor::ChaseTarget()
 
 		if (distanceToTarget <= m_actor->m_currentWeapon->m_enemyMeleeRange)
 		{
-			m_actor->Attack();
+			m_isAttackQueued = true;
 		}
 	}
 	else if (m_currentState == AIState::CHASE && HasLostSightOfTarget(targetActor, m_sightDistance, m_sensorRadius) && m_didAlertTeammates || m_HasBeenAlertedByTeammate)
 	{
-		m_chaseTimer -= m_currentGame->m_clock->GetDeltaSeconds();
-		if (m_chaseTimer <= 0.f)
+		if (HasCountdownExpired(m_chaseCountdown))
 		{
 			m_detectedActor = nullptr;
 			m_HasBeenAlertedByTeammate = false;
 			m_didAlertTeammates = false;
-			m_chaseTimer = m_resetChasetimer;
+			ResetCountdown(m_chaseCountdown);
 			
-			m_switchCurrentStateTimer -= m_currentGame->m_clock->GetDeltaSeconds();
-			if (m_switchCurrentStateTimer <= 0.f)
+			if (HasCountdownExpired(m_switchCurrentStateCountdown))
 			{
 				m_currentState = AIState::PATROL;
-				m_switchCurrentStateTimer = m_restSwitchStateTimer;
+				ResetCountdown(m_switchCurrentStateCountdown);
 				return;
 			}
 		}
@@ -330,7 +564,7 @@ void AIActor::ChaseTarget()
 
 			if (distanceToTarget <= m_actor->m_currentWeapon->m_enemyMeleeRange)
 			{
-				m_actor->Attack();
+				m_isAttackQueued = true;
 			}
 		}
 	}
@@ -339,19 +573,17 @@ void AIActor::ChaseTarget()
 		// Individual AI check if it should revert to patrol state
 		if (!m_didAlertTeammates && !m_HasBeenAlertedByTeammate)
 		{
-			m_losePlayerTimer -= m_currentGame->m_clock->GetDeltaSeconds();
 			m_aiExteriorSenseColor = Rgba8::YELLOW;
 			m_aiInteriorSenseColor = Rgba8::TRANSLUCENT_YELLOW;
-			if (m_losePlayerTimer <= 0.f)
+			if (HasCountdownExpired(m_losePlayerCountdown))
 			{
 				m_detectedActor = nullptr;
 				
-				m_switchStateTimer -= m_currentGame->m_clock->GetDeltaSeconds();
-				if (m_switchStateTimer <= 0.f)
+				if (HasCountdownExpired(m_switchStateCountdown))
 				{
-					m_currentState = AIState::PATROL;
-					m_losePlayerTimer = m_resetLosePlayerTimer;
-					m_switchStateTimer = 1.f;
+					EnterSearchState();
+					ResetCountdown(m_losePlayerCountdown);
+					ResetCountdown(m_switchStateCountdown);
 					return;
 				}
 			}
@@ -361,54 +593,125 @@ void AIActor::ChaseTarget()
 			// Check for other AI agents; This AI agent stays in the chase state
 			if (HasAllAIAgentsLostSightOfPlayer(targetActor))
 			{
-				m_losePlayerTimer -= m_currentGame->m_clock->GetDeltaSeconds();
 				m_aiExteriorSenseColor = Rgba8::YELLOW;
 				m_aiInteriorSenseColor = Rgba8::TRANSLUCENT_YELLOW;
-				if (m_losePlayerTimer <= 0.f)
+				if (HasCountdownExpired(m_losePlayerCountdown))
 				{
-					for (const Actor* actor : m_currentMap->m_actors) // Const because the num actors are not going to change since they can't die
-					{
-						if (actor->m_isAI)
-						{
-							AIActor* aiController = actor->GetAiController();
-							aiController->m_detectedActor = nullptr;
-							aiController->m_HasBeenAlertedByTeammate = false; // Reset the alert status
-							
-							m_switchStateTimer -= m_currentGame->m_clock->GetDeltaSeconds();
-							if (m_switchStateTimer <= 0.f)
-							{
-								aiController->m_currentState = AIState::PATROL;
-								aiController->m_losePlayerTimer = aiController->m_resetLosePlayerTimer;
-								m_switchStateTimer = 1.f;
-								return;
-							}
-						}
-					}
+					m_isStandDownQueued = true;
 				}
 			}
 		}
 	}
 }
 
-void AIActor::AlertOtherAiAgents(Actor* playerActor)
+bool AIActor::HasCountdownExpired(AICountdown& countdown)
 {
-	for (const Actor* actor : m_currentMap->m_actors)
+	// Asking about a countdown that is not running starts it, so each one starts on the first think in its branch
+	if (countdown.m_hasExpired)
+	{
+		return true;
+	}
+	if (countdown.m_isCancelQueued || !m_currentMap->m_timers.IsPending(countdown.m_handle))
 	{
-		if (actor)
+		countdown.m_isStartQueued = true;
+	}
+	return false;
+}
+
+void AIActor::ResetCountdown(AICountdown& countdown)
+{
+	countdown.m_hasExpired = false;
+	countdown.m_isStartQueued = false;
+	countdown.m_isCancelQueued = true;
+}
+
+void AIActor::ApplyCountdownCommands()
+{
+	AICountdown* countdowns[] = { &m_losePlayerCountdown, &m_alertTeammatesCountdown, &m_chaseCountdown, &m_switchCurrentStateCountdown, &m_switchStateCountdown, &m_searchCountdown };
+	for (AICountdown* countdown : countdowns)
+	{
+		if (countdown->m_isCancelQueued)
 		{
-			if (actor->m_isAI)
+			m_currentMap->m_timers.Cancel(countdown->m_handle);
+			countdown->m_isCancelQueued = false;
+		}
+		if (countdown->m_isStartQueued)
+		{
+			if (!countdown->m_hasExpired && !m_currentMap->m_timers.IsPending(countdown->m_handle))
 			{
-				AIActor* aiController = actor->GetAiController();
-				if (aiController->m_currentState != AIState::CHASE)
-				{
-					aiController->m_currentState = AIState::CHASE;
-					aiController->m_HasBeenAlertedByTeammate = true;
-					aiController->m_detectedActor = playerActor;
-					aiController->m_losePlayerTimer = aiController->m_resetLosePlayerTimer;
-				}
+				countdown->m_handle = m_currentMap->m_timers.ScheduleFlag(countdown->m_durationSeconds, &countdown->m_hasExpired, true);
+			}
+			countdown->m_isStartQueued = false;
+		}
+	}
+}
+
+void AIActor::StandDownSquad()
+{
+	// Runs from ApplyCommands, so the other agents' countdowns go to the wheel straight away,
+	// their own ApplyCommands may already have run this step
+	m_currentMap->m_squadBlackboard.StandDown();
+	m_currentMap->m_alertWavefront.Clear();
+	bool isSwitchingState = HasCountdownExpired(m_switchStateCountdown);
+	for (const Actor* actor : m_currentMap->m_actors) // Const because the num actors are not going to change since they can't die
+	{
+		if (actor->m_isAI)
+		{
+			AIActor* aiController = actor->GetAiController();
+			aiController->m_detectedActor = nullptr;
+			aiController->m_HasBeenAlertedByTeammate = false; // Reset the alert status
+			
+			if (isSwitchingState && aiController->m_currentState == AIState::CHASE)
+			{
+				aiController->EnterSearchState();
+				aiController->ResetCountdown(aiController->m_losePlayerCountdown);
+				aiController->ApplyCountdownCommands();
 			}
 		}
 	}
+
+	if (isSwitchingState)
+	{
+		ResetCountdown(m_switchStateCountdown);
+	}
+}
+
+void AIActor::AlertOtherAiAgents(Actor* playerActor)
+{
+	// Only teammates the wave reaches over the next few frames pick the alert up, on their own update
+	m_currentMap->m_squadBlackboard.RaiseGroupAlert(playerActor->m_position, (float)m_currentMap->m_timers.GetElapsedSeconds());
+	m_currentMap->m_alertWavefront.StartWave(*m_currentMap->m_navSnapshot, m_currentMap->GetTileCoordsForPos(m_actor->m_position));
+}
+
+bool AIActor::HasPendingSquadAlert() const
+{
+	return m_currentMap->m_alertWavefront.GetWaveSerialAtTile(m_currentMap->GetTileCoordsForPos(GetActor()->m_position)) > m_lastAlertWaveSerial;
+}
+
+void AIActor::RespondToSquadAlert()
+{
+	const SquadBlackboard& squadBlackboard = m_currentMap->m_squadBlackboard;
+	unsigned int waveSerial = m_currentMap->m_alertWavefront.GetWaveSerialAtTile(m_currentMap->GetTileCoordsForPos(m_actor->m_position));
+	if (waveSerial <= m_lastAlertWaveSerial)
+	{
+		return;
+	}
+	m_lastAlertWaveSerial = waveSerial;
+
+	// Each group alert is answered once, however many of its waves reach this AI
+	if (squadBlackboard.GetAlertSerial() == m_lastSquadAlertSerial)
+	{
+		return;
+	}
+	m_lastSquadAlertSerial = squadBlackboard.GetAlertSerial();
+
+	if (squadBlackboard.GetAlertState() == SquadAlertState::ALERTED && m_currentState != AIState::CHASE)
+	{
+		m_currentState = AIState::CHASE;
+		m_HasBeenAlertedByTeammate = true;
+		m_detectedActor = m_currentMap->GetPlayerActor();
+		ResetCountdown(m_losePlayerCountdown);
+	}
 }
 
 bool AIActor::HasLostSightOfTarget(Actor* playerActor, float fwdSightDistance, float innerSensorRadius) const
@@ -422,36 +725,28 @@ bool AIActor::HasAllAIAgentsLostSightOfPlayer(Actor* playerActor)
 {
 	if (!CanSeeTarget(playerActor))
 	{
-		for (const Actor* actor : m_currentMap->m_actors) // Const because the num actors are not going to change since they can't die
-		{
-			if (actor->m_isAI)
-			{
-				AIActor* aiController = actor->GetAiController();
-				if (aiController->m_currentState == AIState::CHASE && aiController->CanSeeTarget(playerActor)) return false; // If any AI Agent still sees the player return false
-			}
-		}
-		return true; // If no AI Agents can see the player return true
+		// The squad blackboard already counted the chasing AI agents that see the player this frame
+		return m_currentMap->m_squadBlackboard.GetNumChasersSeeingPlayer() == 0;
 	}
 	return false; // Main AI Agent still sees the player
 }
 
 void AStarPathfindingJob::Execute()
 {
-	GridAStar pathfinder(m_mapDimensions);
-	Map* map = m_ai->m_currentMap;
-	pathfinder.SetDirectionMode(DirectionMode::Cardinal8);
-	pathfinder.SetIsSolidCallback([map](IntVec2 coords) { return map->IsSolidTile(coords.x, coords.y); });
-	pathfinder.SetCanMoveDiagonalCallback([map](IntVec2 from, IntVec2 to)
-		{
-			IntVec2 direction = to - from;
-			if (direction.x != 0 && direction.y != 0)
-			{
-				IntVec2 adjacent1 = from + IntVec2(direction.x, 0);
-				IntVec2 adjacent2 = from + IntVec2(0, direction.y);
-				return !map->IsSolidTile(adjacent1.x, adjacent1.y) && !map->IsSolidTile(adjacent2.x, adjacent2.y);
-			}
-			return true; // Its not a valid move to go diagonal
-		});
-	pathfinder.ComputeAStar(m_start, m_goal, m_resultPath);
+	// Only the snapshot is touched here, the map and the requesting AI may be gone by the time this runs
+	if (!m_request.m_goals.empty())
+	{
+		NearestGoalScratch nearestGoalScratch;
+		m_navSnapshot->ComputePathToNearestGoal(m_request.m_start, m_request.m_goals, m_request.m_directionMode, nearestGoalScratch, m_resultPath);
+	}
+	else
+	{
+		m_navSnapshot->ComputePath(m_request.m_start, m_request.m_goal, m_request.m_directionMode, m_resultPath);
+		m_pathCache->AddPath(m_request.m_start, m_request.m_goal, m_request.m_directionMode, m_navSnapshot->GetNavigationMode(m_request.m_directionMode), m_resultPath, m_navSnapshot->GetVersion());
+	}
+	if (m_request.m_isSmoothingPath)
+	{
+		m_navSnapshot->SmoothPath(m_request.m_start, m_resultPath, m_request.m_agentRadius);
+	}
 	m_state = JobStatus::COMPLETED;
 }
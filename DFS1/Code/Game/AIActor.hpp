@@ -1,18 +1,25 @@
 #pragma once
 #include "Game/Controller.hpp"
-#include "Engine/Core/Timer.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/JobSystem.hpp"
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/AI/Pathfinding/Grid/GridAStar.hpp"
+#include "Game/AStarBatchJob.hpp"
+#include "Game/PathCache.hpp"
+#include "Game/AILevelOfDetail.hpp"
+#include "Game/TimerWheel.hpp"
 #include <vector>
 #include <queue>
+#include <memory>
 
 class Game;
 class Map;
 class Timer;
+class NavSnapshot;
+class PathCache;
 
 constexpr int MAX_DISTANCE_THRESHOLD = 32;
 
@@ -20,9 +27,23 @@ enum class AIState
 {
 	PATROL,
 	CHASE,
+	SEARCH,
 	NONE
 };
 
+// One AI countdown on the map's timer wheel, which sets m_hasExpired when it runs out. Think only reads it and queues
+// starts and resets, ApplyCommands hands those to the wheel.
+struct AICountdown
+{
+	explicit AICountdown(float durationSeconds) : m_durationSeconds(durationSeconds) {}
+
+	float m_durationSeconds = 0.f;
+	TimerHandle m_handle;
+	bool m_hasExpired = false;
+	bool m_isStartQueued = false;
+	bool m_isCancelQueued = false;
+};
+
 class AIActor : public Controller
 {
 public:
@@ -32,6 +53,8 @@ public:
 
 	virtual void DamagedBy(Actor* actor) override;
 	virtual void Update() override;
+	void Think();
+	void ApplyCommands();
 
 	void AStarUpdate();
 
@@ -40,19 +63,36 @@ public:
 	
 	// A-Star
 	void RequestPathfindingJob(IntVec2 startPoint, IntVec2 goalPoint);
+	void RequestPathToNearestTarget(IntVec2 startPoint, const std::vector<IntVec2>& targets);
+	void SubmitPathRequest(PathRequest& request);
+	void ReceivePath(const IntVec2* waypoints, size_t numWaypoints);
 
 	// Patrol state
 	void PatrolArea(int patrolRange, IntVec2 startPos);
+	void FollowPatrolNetwork(IntVec2 startPos);
 	bool CanSeeTarget(Actor* playerActor);
-	void FindTargetWithinLineOfSight(Actor* playerActor, float distance, float angle);
-	void FindTargetWithinSensorRadius(Actor* playerActor, float playerDistance);
+	bool FindTargetWithinLineOfSight(Actor* playerActor, float distance, float angle);
+	bool FindTargetWithinSensorRadius(Actor* playerActor, float playerDistance);
+
+	// Search State
+	void SearchArea(IntVec2 startPos);
+	void EnterSearchState();
+	bool IsRepathDue() const;
 
 	// Chase State
 	void ChaseTarget();
 	void AlertOtherAiAgents(Actor* playerActor);
+	void StandDownSquad();
+	void RespondToSquadAlert();
+	bool HasPendingSquadAlert() const;
 	bool HasLostSightOfTarget(Actor* playerActor, float fwdSightDistance, float innerSensorRadius) const;
 	bool HasAllAIAgentsLostSightOfPlayer(Actor* playerActor);
 
+	// Countdowns
+	bool HasCountdownExpired(AICountdown& countdown);
+	void ResetCountdown(AICountdown& countdown);
+	void ApplyCountdownCommands();
+
 public:
 	Game* m_currentGame = nullptr;
 	Map* m_currentMap = nullptr;
@@ -69,23 +109,32 @@ public:
 	Rgba8 m_aiInteriorSenseColor;
 	
 	float m_movementSpeed = 0;
+	DirectionMode m_pathDirectionMode = DirectionMode::Cardinal8;
+	int m_perceptionIndex = -1;
+	unsigned int m_lastSquadAlertSerial = 0;
+	unsigned int m_lastAlertWaveSerial = 0;
+
+	AILODTier m_lodTier = AILODTier::NEAR;
+	bool m_isThinkingThisFrame = true;
 	
-	Timer m_repathTimer;
+	// On the map's timer wheel clock, moved on by one period per repath
+	double m_nextRepathSeconds = 0.0;
 	float m_repathPeriod = 0;
 	
-	float m_losePlayerTimer = 5.f;
-	float m_resetLosePlayerTimer = 5.f;
+	// A countdown starts the first time its branch asks about it and keeps running across branch changes until reset
+	AICountdown m_losePlayerCountdown = AICountdown(5.f);
+	AICountdown m_alertTeammatesCountdown = AICountdown(2.5f);
+	AICountdown m_chaseCountdown = AICountdown(5.f);
+	AICountdown m_switchCurrentStateCountdown = AICountdown(1.f);
+	AICountdown m_switchStateCountdown = AICountdown(1.f);
+	AICountdown m_searchCountdown = AICountdown(10.f);
 
-	float m_alertTeammatesTimer = 2.5f;
-	float m_resetAlertTimer = 2.5f;
+	int m_searchRadius = 12;
 
-	float m_chaseTimer = 5.f;
-	float m_resetChasetimer = 5.f;
+	int m_patrolWaypoint = -1; // Waypoint the current patrol route started from or leads to
+	int m_previousPatrolWaypoint = -1;
 
-	float m_switchCurrentStateTimer = 1.f;
-	float m_restSwitchStateTimer = 1.f;
-
-	float m_switchStateTimer = 1.f;
+	RandomNumberGenerator m_rng; // Own generator, agents thinking on different threads never share one
 
 public:
 	std::vector<IntVec2> m_aiPath;
@@ -103,6 +152,15 @@ public:
 	IntVec2 m_aiStartPos = IntVec2::ZERO;
 
 private:
+	// Effects on the rest of the map recorded by Think and carried out by ApplyCommands
+	bool m_hasQueuedPathRequest = false;
+	PathRequest m_queuedPathRequest;
+	bool m_isAttackQueued = false;
+	bool m_isAlertQueued = false;
+	bool m_isStandDownQueued = false;
+	bool m_isPathCacheTouchQueued = false;
+	PathCacheKey m_queuedPathCacheKey;
+
 	bool m_isWaitingForPath = false; // Tracks if a path request is in progress
 	bool m_isPathStored = false;
 	std::vector<IntVec2> m_currentPth;
@@ -116,17 +174,16 @@ public:
 class AStarPathfindingJob : public Job
 {
 public:
-	AStarPathfindingJob(AIActor* ai, IntVec2 start, IntVec2 goal, IntVec2 mapDimensions)
-		: m_ai(ai), m_start(start), m_goal(goal), m_mapDimensions(mapDimensions) { m_state = JobStatus::NEW; }
+	AStarPathfindingJob(const PathRequest& request, std::shared_ptr<const NavSnapshot> navSnapshot, std::shared_ptr<PathCache> pathCache)
+		: m_request(request), m_navSnapshot(navSnapshot), m_pathCache(pathCache) { m_state = JobStatus::NEW; }
 
 	virtual void Execute() override;
 
 	std::vector<IntVec2> GetResult() const { return m_resultPath; }
 
 public:
-	AIActor* m_ai = nullptr;
-	IntVec2 m_start = IntVec2::ZERO;
-	IntVec2 m_goal = IntVec2::ZERO;
-	IntVec2 m_mapDimensions = IntVec2::ZERO;
+	PathRequest m_request;
+	std::shared_ptr<const NavSnapshot> m_navSnapshot;
+	std::shared_ptr<PathCache> m_pathCache;
 	std::vector<IntVec2> m_resultPath;
 };
@@ -0,0 +1,92 @@
+#include "Game/AILevelOfDetail.hpp"
+#include "Game/Map.hpp"
+#include "Game/Actor.hpp"
+#include "Game/AIActor.hpp"
+
+void AILevelOfDetail::Initialize(bool isEnabled, float nearRadius, float midRadius, int midThinkInterval)
+{
+	m_isEnabled = isEnabled;
+	m_nearRadius = nearRadius;
+	m_midRadius = midRadius;
+	m_midThinkInterval = midThinkInterval > 0 ? midThinkInterval : 1;
+}
+
+void AILevelOfDetail::Update(Map* map)
+{
+	m_frameNumber++;
+	m_numAgentsInTier[0] = 0;
+	m_numAgentsInTier[1] = 0;
+	m_numAgentsInTier[2] = 0;
+	m_numThinkingLastUpdate = 0;
+
+	Actor* playerActor = map->GetPlayerActor();
+	int agentIndex = 0;
+	for (Actor* actor : map->m_actors)
+	{
+		if (actor == nullptr || !actor->m_isAI || actor->GetAiController() == nullptr)
+		{
+			continue;
+		}
+		AIActor* aiController = actor->GetAiController();
+
+		AILODTier tier = AILODTier::NEAR;
+		if (m_isEnabled && playerActor != nullptr && aiController->m_currentState != AIState::CHASE)
+		{
+			Vec3 toPlayer = playerActor->m_position - actor->m_position;
+			float distanceSq = toPlayer.x * toPlayer.x + toPlayer.y * toPlayer.y;
+			if (distanceSq > m_midRadius * m_midRadius)
+			{
+				tier = AILODTier::FAR;
+			}
+			else if (distanceSq > m_nearRadius * m_nearRadius)
+			{
+				tier = AILODTier::MID;
+			}
+
+			// Anything that would change a far agent's mind wakes it for this frame
+			bool isWakeEvent = map->m_perception.CanSeePlayer(aiController->m_perceptionIndex) || aiController->HasPendingSquadAlert();
+			if (tier == AILODTier::FAR && (isWakeEvent || aiController->m_currentState == AIState::SEARCH))
+			{
+				tier = AILODTier::MID;
+			}
+			if (isWakeEvent)
+			{
+				tier = AILODTier::NEAR;
+			}
+		}
+
+		aiController->m_lodTier = tier;
+		m_numAgentsInTier[static_cast<int>(tier)]++;
+
+		if (tier == AILODTier::FAR)
+		{
+			aiController->m_isThinkingThisFrame = false;
+		}
+		else
+		{
+			// Mid range agents are staggered so the same share of them thinks every frame
+			bool isThinking = tier == AILODTier::NEAR || (m_frameNumber + agentIndex) % m_midThinkInterval == 0;
+			aiController->m_isThinkingThisFrame = isThinking;
+			if (isThinking)
+			{
+				m_numThinkingLastUpdate++;
+			}
+		}
+		agentIndex++;
+	}
+}
+
+bool AILevelOfDetail::IsEnabled() const
+{
+	return m_isEnabled;
+}
+
+int AILevelOfDetail::GetNumAgentsInTier(AILODTier tier) const
+{
+	return m_numAgentsInTier[static_cast<int>(tier)];
+}
+
+int AILevelOfDetail::GetNumThinkingLastUpdate() const
+{
+	return m_numThinkingLastUpdate;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+class Map;
+
+enum class AILODTier
+{
+	NEAR,
+	MID,
+	FAR
+};
+
+// Decides once per frame how much work every AI does. Near agents think every frame, mid range agents
+// think every few frames, and far agents sleep until they see the player, an alert wave reaches them or the
+// player comes within range. AI countdowns run on the map's timer wheel, so skipped frames still count.
+// Chasing AIs always think every frame, searching AIs never drop below the mid tier.
+class AILevelOfDetail
+{
+public:
+	AILevelOfDetail() = default;
+	~AILevelOfDetail() = default;
+
+	void Initialize(bool isEnabled, float nearRadius, float midRadius, int midThinkInterval);
+	void Update(Map* map);
+
+	bool IsEnabled() const;
+	int GetNumAgentsInTier(AILODTier tier) const;
+	int GetNumThinkingLastUpdate() const;
+
+private:
+	bool m_isEnabled = true;
+	float m_nearRadius = 16.f;
+	float m_midRadius = 40.f;
+	int m_midThinkInterval = 4;
+	unsigned int m_frameNumber = 0;
+	int m_numAgentsInTier[3] = {};
+	int m_numThinkingLastUpdate = 0;
+};
@@ -0,0 +1,66 @@
+#include "Game/AStarBatchJob.hpp"
+#include "Game/NavSnapshot.hpp"
+#include "Game/PathCache.hpp"
+#include "Game/Map.hpp"
+
+AStarBatchJob::AStarBatchJob(std::shared_ptr<const NavSnapshot> navSnapshot, std::shared_ptr<PathCache> pathCache, std::vector<PathRequest>::const_iterator firstRequest, std::vector<PathRequest>::const_iterator lastRequest)
+	:m_navSnapshot(navSnapshot), m_pathCache(pathCache), m_requests(firstRequest, lastRequest)
+{
+	m_state = JobStatus::NEW;
+	m_resultRanges.resize(m_requests.size());
+}
+
+void AStarBatchJob::Execute()
+{
+	const NavSnapshot& navSnapshot = *m_navSnapshot;
+	const NavRectGraph* rectGraph = navSnapshot.GetRectGraph();
+	GridAStar pathfinder(navSnapshot.GetDimensions());
+	navSnapshot.ConfigureGridAStar(pathfinder);
+
+	// Rough guess of a patrol path length so the path buffer rarely has to grow
+	m_pathBuffer.reserve(m_requests.size() * 16);
+	std::vector<IntVec2> scratchPath;
+	NearestGoalScratch nearestGoalScratch;
+
+	for (size_t requestIndex = 0; requestIndex < m_requests.size(); requestIndex++)
+	{
+		const PathRequest& request = m_requests[requestIndex];
+		scratchPath.clear();
+		if (!request.m_goals.empty())
+		{
+			navSnapshot.ComputePathToNearestGoal(request.m_start, request.m_goals, request.m_directionMode, nearestGoalScratch, scratchPath);
+		}
+		else
+		{
+			NavigationMode navigationMode = navSnapshot.GetNavigationMode(request.m_directionMode);
+			if (navigationMode == NavigationMode::RECT)
+			{
+				rectGraph->FindPath(request.m_start, request.m_goal, scratchPath);
+			}
+			else
+			{
+				pathfinder.SetDirectionMode(request.m_directionMode);
+				pathfinder.ComputeAStar(request.m_start, request.m_goal, scratchPath);
+			}
+			m_pathCache->AddPath(request.m_start, request.m_goal, request.m_directionMode, navigationMode, scratchPath, navSnapshot.GetVersion());
+		}
+		if (request.m_isSmoothingPath)
+		{
+			navSnapshot.SmoothPath(request.m_start, scratchPath, request.m_agentRadius);
+		}
+
+		m_resultRanges[requestIndex].m_offset = m_pathBuffer.size();
+		m_resultRanges[requestIndex].m_count = scratchPath.size();
+		m_pathBuffer.insert(m_pathBuffer.end(), scratchPath.begin(), scratchPath.end());
+	}
+	m_state = JobStatus::COMPLETED;
+}
+
+void AStarBatchJob::PublishResults(Map* map) const
+{
+	for (size_t requestIndex = 0; requestIndex < m_requests.size(); requestIndex++)
+	{
+		const PathResultRange& range = m_resultRanges[requestIndex];
+		map->DeliverPath(m_requests[requestIndex].m_aiUID, m_pathBuffer.data() + range.m_offset, range.m_count);
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Game/ActorUID.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/AI/Pathfinding/Grid/GridAStar.hpp"
+#include <vector>
+#include <memory>
+
+class Map;
+class NavSnapshot;
+class PathCache;
+
+struct PathRequest
+{
+	ActorUID m_aiUID = ActorUID::INVALID;
+	IntVec2 m_start = IntVec2::ZERO;
+	IntVec2 m_goal = IntVec2::ZERO;
+	std::vector<IntVec2> m_goals; // When set the path leads to whichever of these is nearest and m_goal is ignored
+	DirectionMode m_directionMode = DirectionMode::Cardinal8;
+	bool m_isSmoothingPath = false;
+	float m_agentRadius = 0.f;
+};
+
+// Location of one request's path inside the job's path buffer
+struct PathResultRange
+{
+	size_t m_offset = 0;
+	size_t m_count = 0;
+};
+
+// Solves a slice of the frame's path requests one after another, writing every path into a single
+// buffer owned by the job instead of allocating a vector per request
+class AStarBatchJob : public Job
+{
+public:
+	AStarBatchJob(std::shared_ptr<const NavSnapshot> navSnapshot, std::shared_ptr<PathCache> pathCache, std::vector<PathRequest>::const_iterator firstRequest, std::vector<PathRequest>::const_iterator lastRequest);
+
+	virtual void Execute() override;
+
+	void PublishResults(Map* map) const;
+
+public:
+	std::shared_ptr<const NavSnapshot> m_navSnapshot;
+	std::shared_ptr<PathCache> m_pathCache;
+	std::vector<PathRequest> m_requests;
+	std::vector<PathResultRange> m_resultRanges;
+	std::vector<IntVec2> m_pathBuffer;
+};
@@ -24,7 +24,6 @@
 Actor::Actor(Map* owner, SpawnInfo spawnInfo, ActorUID actorUID)
 {
 	m_map = owner;
-	m_animClock = new Clock(*m_map->m_game->m_clock);
 	m_actorDefName = spawnInfo.m_actorType;
 	m_position = spawnInfo.m_actorPosition;
 	m_orientation = spawnInfo.m_actorOrientation;
@@ -126,39 +125,15 @@ Actor::~Actor()
 
 	m_actorInventory.clear();
 	SafeDelete(m_currentWeapon);
+	SafeDelete(m_item);
 }
 
 void Actor::Update()
 {
-	if (m_currentWeapon)
-	{
-		m_currentWeapon->Update();
-	}
-
-	if (m_isVisible && !m_isItem)
-	{
-		m_owningController->Update();
-	}
-
-	if (m_isItem)
-	{
-		m_item->Update();
-	}
-
-	UpdatePhysiscs();
-
-	if (!m_isFlying)
+	// The map has already run AI controllers in its think phase when that is on
+	if (m_isVisible && !m_isItem && !(m_map->m_isThinkingAIsInPhases && IsControlledByAI()))
 	{
-		m_position.z = 0.f;
-	}
-
-	if (m_isDead)
-	{
-		m_corpseLifeTime -= m_map->m_game->m_clock->GetDeltaSeconds();
-		if (m_corpseLifeTime <= 0.f)
-		{
-			m_isDestroyed = true;
-		}
+		m_owningController->UpdateStep();
 	}
 }
 
@@ -208,12 +183,10 @@ void Actor::CreateBuffers()
 	}
 }
 
-void Actor::Render()
+void Actor::Render(const ActorRenderState& renderState) const
 {
-	if (!m_isVisible) return;
-
-	std::vector<Vertex_PCU> actorVerts;
-	switch (m_type)
+	// Draws from the snapshot's transform, the live actor may already be a simulation step further on
+	switch (renderState.m_type)
 	{
 	case ActorType::ACTOR_ENEMY:
 	{
@@ -221,7 +194,7 @@ void Actor::Render()
 		g_theRenderer->SetDepthMode(DepthMode::ENABLED);
 		g_theRenderer->SetRasterizerState(RasterizerMode::SOLID_CULL_NONE);
 		g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-		g_theRenderer->SetModelConstants(GetModelMatrix(), m_enemyColor);
+		g_theRenderer->SetModelConstants(renderState.m_modelMatrix, renderState.m_color);
 		g_theRenderer->BindTexture(0, nullptr);
 		g_theRenderer->BindShader(nullptr);
 		g_theRenderer->DrawVertexBufferIndex(m_bodyVertexBuffer, m_bodyIndexBuffer, VertexType::Vertex_PCU, static_cast<int>(m_actorBodyIndicies.size()));
@@ -233,12 +206,12 @@ void Actor::Render()
 		g_theRenderer->SetDepthMode(DepthMode::ENABLED);
 		g_theRenderer->SetRasterizerState(RasterizerMode::SOLID_CULL_NONE);
 		g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-		g_theRenderer->SetModelConstants(GetModelMatrix(), m_playerColor);
+		g_theRenderer->SetModelConstants(renderState.m_modelMatrix, renderState.m_color);
 		g_theRenderer->BindTexture(0, nullptr);
 		g_theRenderer->BindShader(nullptr);
 		g_theRenderer->DrawVertexBufferIndex(m_bodyVertexBuffer, m_bodyIndexBuffer, VertexType::Vertex_PCU, static_cast<int>(m_actorBodyIndicies.size()));
 		
-		g_theRenderer->SetModelConstants(GetModelMatrix(), m_playerEyeColor);
+		g_theRenderer->SetModelConstants(renderState.m_modelMatrix, renderState.m_eyeColor);
 		g_theRenderer->DrawVertexBufferIndex(m_playerEyeVertexBuffer, m_playerEyeIndexBuffer, VertexType::Vertex_PCU, static_cast<int>(m_playerActorEyeIndicies.size()));
 		break;
 	}
@@ -247,7 +220,7 @@ void Actor::Render()
 		g_theRenderer->SetBlendMode(BlendMode::ALPHA);
 		g_theRenderer->SetDepthMode(DepthMode::ENABLED);
 		g_theRenderer->SetRasterizerState(RasterizerMode::SOLID_CULL_BACK);
-		g_theRenderer->SetModelConstants(GetModelMatrix(), m_itemColor);
+		g_theRenderer->SetModelConstants(renderState.m_modelMatrix, renderState.m_color);
 		g_theRenderer->BindTexture(0, m_map->m_game->m_hourglassTexture);
 		g_theRenderer->BindShader(nullptr);
 		g_theRenderer->DrawVertexBufferIndex(m_itemVertexBuffer, m_itemIndexBuffer, VertexType::Vertex_PCU, static_cast<int>(m_itemIndicies.size()));
@@ -259,6 +232,29 @@ void Actor::Render()
 	}
 }
 
+ActorRenderState Actor::GetRenderState() const
+{
+	ActorRenderState renderState;
+	renderState.m_actor = this;
+	renderState.m_type = m_type;
+	renderState.m_modelMatrix = GetRenderModelMatrix();
+	switch (m_type)
+	{
+	case ActorType::ACTOR_ENEMY:
+		renderState.m_color = m_enemyColor;
+		break;
+	case ActorType::ACTOR_PLAYER:
+		renderState.m_color = m_playerColor;
+		renderState.m_eyeColor = m_playerEyeColor;
+		break;
+	case ActorType::ACTOR_ITEMBOX:
+		renderState.m_modelMatrix = m_item->GetAnimatedModelMatrix(m_position);
+		renderState.m_color = m_itemColor;
+		break;
+	}
+	return renderState;
+}
+
 Mat44 Actor::GetModelMatrix()
 {
 	Mat44 translation = Mat44::CreateTranslation3D(m_position);
@@ -268,6 +264,31 @@ Mat44 Actor::GetModelMatrix()
 	return translation;
 }
 
+Vec3 Actor::GetRenderPosition() const
+{
+	return m_previousPosition + (m_position - m_previousPosition) * m_map->m_stepInterpolation;
+}
+
+EulerAngles Actor::GetRenderOrientation() const
+{
+	// Each angle takes the short way round so a yaw crossing 0/360 does not spin the wrong way for a frame
+	float fraction = m_map->m_stepInterpolation;
+	EulerAngles renderOrientation = m_previousOrientation;
+	renderOrientation.m_yawDegrees += GetShortestAngularDispDegrees(m_previousOrientation.m_yawDegrees, m_orientation.m_yawDegrees) * fraction;
+	renderOrientation.m_pitchDegrees += GetShortestAngularDispDegrees(m_previousOrientation.m_pitchDegrees, m_orientation.m_pitchDegrees) * fraction;
+	renderOrientation.m_rollDegrees += GetShortestAngularDispDegrees(m_previousOrientation.m_rollDegrees, m_orientation.m_rollDegrees) * fraction;
+	return renderOrientation;
+}
+
+Mat44 Actor::GetRenderModelMatrix() const
+{
+	Mat44 translation = Mat44::CreateTranslation3D(GetRenderPosition());
+	Mat44 orientation = GetRenderOrientation().GetAsMatrix_IFwd_JLeft_KUp();
+
+	translation.Append(orientation);
+	return translation;
+}
+
 ActorType Actor::GetType()
 {
 	return m_type;
@@ -293,38 +314,27 @@ AIActor* Actor::GetAiController() const
 	return m_aiController;
 }
 
-void Actor::UpdatePhysiscs()
+bool Actor::IsControlledByAI() const
 {
-	float deltaSeconds = m_map->m_game->m_clock->GetDeltaSeconds();
-
-	if (!m_isMoveable || m_isCorspe)
-	{
-		return;
-	}
-
-	Vec3 drag = -m_velocity;
-	AddForce(drag);
-
-	// Update velocity 
-	m_velocity += m_acceleration * deltaSeconds * 0.5f;
-
-	// update position
-	m_position += m_velocity * deltaSeconds;
-
-	m_velocity += m_acceleration * deltaSeconds * 0.5f;
-
-	// Reset acceleration for next frame
-	m_acceleration = Vec3::ZERO;
+	return m_aiController != nullptr && m_owningController == m_aiController;
 }
 
 void Actor::AddForce(const Vec3& force)
 {
-	m_acceleration += force * m_dragForce;
+	int row = m_map->GetActorRow(m_uid);
+	if (row >= 0)
+	{
+		m_map->m_actorPhysics.AddForce(row, force);
+	}
 }
 
 void Actor::AddImpulse(const Vec3& impulse)
 {
-	m_velocity += impulse;
+	int row = m_map->GetActorRow(m_uid);
+	if (row >= 0)
+	{
+		m_map->m_actorPhysics.AddImpulse(row, impulse);
+	}
 }
 
 void Actor::MoveInDirection(Vec3 direction, float speed)
@@ -341,8 +351,33 @@ void Actor::TurnInDirection(float goalDegree, float maxAngle)
 void Actor::OnCollide()
 {
 	m_map->m_gameTime += 5.f;
-	m_map->m_didAddTime = true;
+	if (!m_map->m_didAddTime)
+	{
+		// Shown for a second from the first pick up, more pick ups inside that second do not stretch it
+		m_map->m_didAddTime = true;
+		m_map->m_timers.ScheduleFlag(1.f, &m_map->m_didAddTime, false);
+	}
+	Die();
+}
+
+void Actor::Die()
+{
+	if (m_isDead)
+	{
+		return;
+	}
 	m_isDead = true;
+	m_map->m_timers.Schedule(m_corpseLifeTime, &Actor::OnCorpseTimerExpired, m_uid);
+}
+
+STATIC void Actor::OnCorpseTimerExpired(Map* map, const ActorUID& actorUID)
+{
+	// The corpse may already be gone, in which case its slot no longer matches the UID
+	Actor* actor = map->GetActorByUID(actorUID);
+	if (actor)
+	{
+		actor->m_isDestroyed = true;
+	}
 }
 
 void Actor::OnPossessed(Controller* controller)
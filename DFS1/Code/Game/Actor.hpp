@@ -7,14 +7,12 @@
 #include "Engine/Renderer/SpriteAnimDefinition.hpp"
 #include <vector>
 
-class Clock;
 class Map;
 class Game;
 class Controller;
 class AIActor;
 class Item;
 class Weapon;
-class Timer;
 class Shader;
 class SpriteSheet;
 class SpriteDefinition;
@@ -23,6 +21,7 @@ class VertexBuffer;
 class IndexBuffer;
 struct SpawnInfo;
 struct ActorDefinition;
+struct ActorRenderState;
 
 class Actor
 {
@@ -36,22 +35,28 @@ public:
 	void CreateZAlignedAgent();
 	void CreateItemBox();
 	void CreateBuffers();
-	void Render();
+	void Render(const ActorRenderState& renderState) const;
+	ActorRenderState GetRenderState() const;
 	Mat44 GetModelMatrix();
+	Vec3 GetRenderPosition() const;
+	EulerAngles GetRenderOrientation() const;
+	Mat44 GetRenderModelMatrix() const;
 
 	ActorType GetType();
 	ActorUID GetUID() const;
 	void SetUID(ActorUID uid);
 	Controller* GetController() const;
 	AIActor* GetAiController() const;
+	bool IsControlledByAI() const;
 
-	void UpdatePhysiscs();
 	void AddForce(const Vec3& force);
 	void AddImpulse(const Vec3& impulse);
 	void MoveInDirection(Vec3 direction, float speed);
 	void TurnInDirection(float goalDegree, float maxAngle);
 
 	void OnCollide();
+	void Die();
+	static void OnCorpseTimerExpired(Map* map, const ActorUID& actorUID);
 
 	void OnPossessed(Controller* controller);
 	void OnUnPossessed(Controller* controller);
@@ -74,18 +79,16 @@ public:
 
 public:
 	Map* m_map = nullptr;
-	Clock* m_animClock = nullptr;
-	Timer* m_animTimer = nullptr;
 	ActorDefinition* m_actorDef = nullptr;
 	ActorType m_type = ActorType::UNKNOWN;
 	std::string m_actorDefName;
 	ActorUID m_uid;
 	ActorUID m_ownerUID;
 
-	Vec3 m_acceleration = Vec3::ZERO;
-	Vec3 m_velocity = Vec3::ZERO;
 	Vec3 m_preferredVelocity = Vec3::ZERO;
 	Vec3 m_position = Vec3::ZERO;
+	Vec3 m_previousPosition = Vec3::ZERO; // Transform before the last simulation step, rendering blends from it
+	EulerAngles m_previousOrientation = EulerAngles::ZERO;
 	
 	EulerAngles m_orientation = EulerAngles::ZERO;
 
@@ -120,7 +123,7 @@ public:
 	bool m_isFlying = false;
 	float m_sightRadii = 0.f;
 	float m_sightAngle = 0.f;
-	float m_dragForce = 0.f;
+	float m_dragForce = 0.f; // Copied into the actor's physics row when it is added to the map
 	float m_corpseLifeTime = 0.f;
 	bool m_dieOnCollide = false;
 	bool m_isTakingDamage = false;
@@ -0,0 +1,97 @@
+#include "Game/ActorContactIslands.hpp"
+#include <algorithm>
+
+void ActorContactIslands::Build(const std::vector<std::pair<unsigned int, unsigned int>>& pairs, int numSlots)
+{
+	m_slotParents.assign(numSlots, -1);
+	m_rootIslands.assign(numSlots, -1);
+	int numPairs = static_cast<int>(pairs.size());
+
+	// Union find over actor slots, each pair joins the islands of its two actors
+	for (const std::pair<unsigned int, unsigned int>& pair : pairs)
+	{
+		int slotA = static_cast<int>(pair.first);
+		int slotB = static_cast<int>(pair.second);
+		if (m_slotParents[slotA] == -1)
+		{
+			m_slotParents[slotA] = slotA;
+		}
+		if (m_slotParents[slotB] == -1)
+		{
+			m_slotParents[slotB] = slotB;
+		}
+
+		int rootA = FindRoot(slotA);
+		int rootB = FindRoot(slotB);
+		if (rootA != rootB)
+		{
+			m_slotParents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+		}
+	}
+
+	// Islands are numbered in the order their first pair shows up, then pairs are bucketed by island keeping their order
+	int numIslands = 0;
+	m_pairIslands.resize(numPairs);
+	for (int pairIndex = 0; pairIndex < numPairs; pairIndex++)
+	{
+		int root = FindRoot(static_cast<int>(pairs[pairIndex].first));
+		if (m_rootIslands[root] == -1)
+		{
+			m_rootIslands[root] = numIslands++;
+		}
+		m_pairIslands[pairIndex] = m_rootIslands[root];
+	}
+
+	m_islandPairStarts.assign(numIslands + 1, 0);
+	for (int pairIndex = 0; pairIndex < numPairs; pairIndex++)
+	{
+		m_islandPairStarts[m_pairIslands[pairIndex] + 1]++;
+	}
+
+	m_largestIslandSize = 0;
+	for (int islandIndex = 0; islandIndex < numIslands; islandIndex++)
+	{
+		m_largestIslandSize = std::max(m_largestIslandSize, m_islandPairStarts[islandIndex + 1]);
+		m_islandPairStarts[islandIndex + 1] += m_islandPairStarts[islandIndex];
+	}
+
+	m_islandPairs.resize(numPairs);
+	std::vector<int> nextPairSlots(m_islandPairStarts.begin(), m_islandPairStarts.end() - 1);
+	for (int pairIndex = 0; pairIndex < numPairs; pairIndex++)
+	{
+		m_islandPairs[nextPairSlots[m_pairIslands[pairIndex]]++] = pairIndex;
+	}
+}
+
+int ActorContactIslands::GetNumIslands() const
+{
+	return m_islandPairStarts.empty() ? 0 : static_cast<int>(m_islandPairStarts.size()) - 1;
+}
+
+int ActorContactIslands::GetNumPairs() const
+{
+	return static_cast<int>(m_islandPairs.size());
+}
+
+int ActorContactIslands::GetLargestIslandSize() const
+{
+	return m_largestIslandSize;
+}
+
+const int* ActorContactIslands::GetIslandPairs(int islandIndex, int& outNumPairs) const
+{
+	int firstPair = m_islandPairStarts[islandIndex];
+	outNumPairs = m_islandPairStarts[islandIndex + 1] - firstPair;
+	return m_islandPairs.data() + firstPair;
+}
+
+int ActorContactIslands::FindRoot(int slotIndex)
+{
+	// Path halving keeps the chains short without a second pass
+	while (m_slotParents[slotIndex] != slotIndex)
+	{
+		m_slotParents[slotIndex] = m_slotParents[m_slotParents[slotIndex]];
+		slotIndex = m_slotParents[slotIndex];
+	}
+	return slotIndex;
+}
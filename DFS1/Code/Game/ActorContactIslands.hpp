@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+// Splits one frame's colliding actor pairs into islands, groups of actors linked to each other through
+// contacts. No actor is in two islands, so islands can be resolved at the same time on different threads.
+// Pairs keep the order they were given in within their island and islands are numbered by their first pair,
+// so resolving every island gives exactly what walking the pairs one by one would, on any number of threads.
+class ActorContactIslands
+{
+public:
+	ActorContactIslands() = default;
+	~ActorContactIslands() = default;
+
+	void Build(const std::vector<std::pair<unsigned int, unsigned int>>& pairs, int numSlots);
+
+	int GetNumIslands() const;
+	int GetNumPairs() const;
+	int GetLargestIslandSize() const; // In pairs
+	const int* GetIslandPairs(int islandIndex, int& outNumPairs) const; // Indexes into the pairs given to Build
+
+private:
+	int FindRoot(int slotIndex);
+
+private:
+	std::vector<int> m_slotParents; // -1 for slots in no pair this frame
+	std::vector<int> m_rootIslands;
+	std::vector<int> m_pairIslands;
+	std::vector<int> m_islandPairStarts; // One past the last island as well
+	std::vector<int> m_islandPairs;
+	int m_largestIslandSize = 0;
+};
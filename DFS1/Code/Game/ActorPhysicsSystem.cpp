@@ -0,0 +1,311 @@
+#include "Game/ActorPhysicsSystem.hpp"
+#include "Game/Actor.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <chrono>
+#include <memory>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define ACTOR_PHYSICS_USE_SSE
+#endif
+
+void ActorPhysicsSystem::Clear()
+{
+	m_numRows = 0;
+	m_numSimulatedRows = 0;
+	ResizeRows(0);
+}
+
+void ActorPhysicsSystem::AddRow(float drag)
+{
+	int row = m_numRows;
+	ResizeRows(m_numRows + 1);
+	m_drag[row] = drag;
+}
+
+void ActorPhysicsSystem::RemoveRow(int row)
+{
+	int lastRow = m_numRows - 1;
+	if (row != lastRow)
+	{
+		m_velocityX[row] = m_velocityX[lastRow];
+		m_velocityY[row] = m_velocityY[lastRow];
+		m_velocityZ[row] = m_velocityZ[lastRow];
+		m_accelerationX[row] = m_accelerationX[lastRow];
+		m_accelerationY[row] = m_accelerationY[lastRow];
+		m_accelerationZ[row] = m_accelerationZ[lastRow];
+		m_drag[row] = m_drag[lastRow];
+	}
+	ResizeRows(lastRow);
+}
+
+void ActorPhysicsSystem::ResizeRows(int numRows)
+{
+	// Shrinking then growing back resets the vacated rows, so reused rows start at rest
+	int paddedSize = (numRows + 3) & ~3;
+	for (std::vector<float>* column : { &m_positionX, &m_positionY, &m_positionZ, &m_velocityX, &m_velocityY, &m_velocityZ, &m_accelerationX, &m_accelerationY, &m_accelerationZ, &m_drag })
+	{
+		column->resize(numRows);
+		column->resize(paddedSize, 0.f);
+	}
+	m_simulatedMask.resize(numRows);
+	m_simulatedMask.resize(paddedSize, 0);
+	m_isFlying.resize(numRows);
+	m_isFlying.resize(paddedSize, 0);
+	m_numRows = numRows;
+}
+
+void ActorPhysicsSystem::AddForce(int row, const Vec3& force)
+{
+	m_accelerationX[row] += force.x * m_drag[row];
+	m_accelerationY[row] += force.y * m_drag[row];
+	m_accelerationZ[row] += force.z * m_drag[row];
+}
+
+void ActorPhysicsSystem::AddImpulse(int row, const Vec3& impulse)
+{
+	m_velocityX[row] += impulse.x;
+	m_velocityY[row] += impulse.y;
+	m_velocityZ[row] += impulse.z;
+}
+
+Vec3 ActorPhysicsSystem::GetVelocity(int row) const
+{
+	return Vec3(m_velocityX[row], m_velocityY[row], m_velocityZ[row]);
+}
+
+void ActorPhysicsSystem::BeginUpdate()
+{
+	m_updateStart = std::chrono::high_resolution_clock::now();
+}
+
+void ActorPhysicsSystem::UpdateRows(std::vector<Actor*>& actors, int firstRow, int lastRow, float deltaSeconds)
+{
+	if (firstRow >= lastRow)
+	{
+		return;
+	}
+
+	GatherActors(actors, firstRow, lastRow);
+	Integrate(firstRow, lastRow, deltaSeconds);
+	ScatterActors(actors, firstRow, lastRow);
+}
+
+void ActorPhysicsSystem::EndUpdate()
+{
+	m_numSimulatedRows = 0;
+	for (int row = 0; row < m_numRows; row++)
+	{
+		m_numSimulatedRows += m_simulatedMask[row] != 0 ? 1 : 0;
+	}
+
+	auto updateEnd = std::chrono::high_resolution_clock::now();
+	m_lastUpdateMS = std::chrono::duration<float, std::milli>(updateEnd - m_updateStart).count();
+}
+
+void ActorPhysicsSystem::GatherActors(const std::vector<Actor*>& actors, int firstRow, int lastRow)
+{
+	// Movability and corpse state change during play, so the mask is rebuilt every frame
+	for (int row = firstRow; row < lastRow; row++)
+	{
+		const Actor* actor = actors[row];
+		m_positionX[row] = actor->m_position.x;
+		m_positionY[row] = actor->m_position.y;
+		m_positionZ[row] = actor->m_position.z;
+		m_isFlying[row] = actor->m_isFlying ? 1 : 0;
+		m_simulatedMask[row] = actor->m_isMoveable && !actor->m_isCorspe ? 0xFFFFFFFFu : 0u;
+	}
+}
+
+void ActorPhysicsSystem::Integrate(int firstRow, int lastRow, float deltaSeconds)
+{
+	// A slice ending part way through a block of four takes the whole block, the rest of it is padding
+	int lastPaddedRow = (lastRow + 3) & ~3;
+
+#ifdef ACTOR_PHYSICS_USE_SSE
+	// Drag is folded into the acceleration, then velocity takes half a step either side of the move.
+	// Lanes outside the mask keep every value, including acceleration they have built up
+	__m128 timeStep = _mm_set1_ps(deltaSeconds);
+	__m128 halfTimeStep = _mm_set1_ps(deltaSeconds * 0.5f);
+	for (int row = firstRow; row < lastPaddedRow; row += 4)
+	{
+		__m128 mask = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_simulatedMask[row])));
+		__m128 drag = _mm_loadu_ps(&m_drag[row]);
+
+		float* positions[3] = { &m_positionX[row], &m_positionY[row], &m_positionZ[row] };
+		float* velocities[3] = { &m_velocityX[row], &m_velocityY[row], &m_velocityZ[row] };
+		float* accelerations[3] = { &m_accelerationX[row], &m_accelerationY[row], &m_accelerationZ[row] };
+		for (int axis = 0; axis < 3; axis++)
+		{
+			__m128 position = _mm_loadu_ps(positions[axis]);
+			__m128 velocity = _mm_loadu_ps(velocities[axis]);
+			__m128 acceleration = _mm_loadu_ps(accelerations[axis]);
+
+			__m128 totalAcceleration = _mm_sub_ps(acceleration, _mm_mul_ps(velocity, drag));
+			__m128 halfVelocityStep = _mm_mul_ps(totalAcceleration, halfTimeStep);
+			__m128 midVelocity = _mm_add_ps(velocity, halfVelocityStep);
+			__m128 newPosition = _mm_add_ps(position, _mm_mul_ps(midVelocity, timeStep));
+			__m128 newVelocity = _mm_add_ps(midVelocity, halfVelocityStep);
+
+			_mm_storeu_ps(positions[axis], _mm_or_ps(_mm_and_ps(mask, newPosition), _mm_andnot_ps(mask, position)));
+			_mm_storeu_ps(velocities[axis], _mm_or_ps(_mm_and_ps(mask, newVelocity), _mm_andnot_ps(mask, velocity)));
+			_mm_storeu_ps(accelerations[axis], _mm_andnot_ps(mask, acceleration));
+		}
+	}
+#else
+	IntegrateScalar(firstRow, lastPaddedRow, deltaSeconds);
+#endif
+}
+
+void ActorPhysicsSystem::IntegrateScalar(int firstRow, int lastRow, float deltaSeconds)
+{
+	float halfTimeStep = deltaSeconds * 0.5f;
+	for (int row = firstRow; row < lastRow; row++)
+	{
+		if (m_simulatedMask[row] == 0)
+		{
+			continue;
+		}
+
+		float accelerationX = m_accelerationX[row] - m_velocityX[row] * m_drag[row];
+		float accelerationY = m_accelerationY[row] - m_velocityY[row] * m_drag[row];
+		float accelerationZ = m_accelerationZ[row] - m_velocityZ[row] * m_drag[row];
+
+		m_velocityX[row] += accelerationX * halfTimeStep;
+		m_velocityY[row] += accelerationY * halfTimeStep;
+		m_velocityZ[row] += accelerationZ * halfTimeStep;
+
+		m_positionX[row] += m_velocityX[row] * deltaSeconds;
+		m_positionY[row] += m_velocityY[row] * deltaSeconds;
+		m_positionZ[row] += m_velocityZ[row] * deltaSeconds;
+
+		m_velocityX[row] += accelerationX * halfTimeStep;
+		m_velocityY[row] += accelerationY * halfTimeStep;
+		m_velocityZ[row] += accelerationZ * halfTimeStep;
+
+		m_accelerationX[row] = 0.f;
+		m_accelerationY[row] = 0.f;
+		m_accelerationZ[row] = 0.f;
+	}
+}
+
+void ActorPhysicsSystem::ScatterActors(std::vector<Actor*>& actors, int firstRow, int lastRow) const
+{
+	for (int row = firstRow; row < lastRow; row++)
+	{
+		// Walkers are pinned to the floor whether or not they were simulated
+		float positionZ = m_isFlying[row] ? m_positionZ[row] : 0.f;
+		actors[row]->m_position = Vec3(m_positionX[row], m_positionY[row], positionZ);
+	}
+}
+
+int ActorPhysicsSystem::GetNumRows() const
+{
+	return m_numRows;
+}
+
+int ActorPhysicsSystem::GetNumSimulatedRows() const
+{
+	return m_numSimulatedRows;
+}
+
+float ActorPhysicsSystem::GetLastUpdateMS() const
+{
+	return m_lastUpdateMS;
+}
+
+STATIC void ActorPhysicsSystem::RunBenchmark(int numRows, std::vector<std::string>& outLines)
+{
+	// Compares the old layout, one heap object per actor holding its own state among everything else an
+	// actor carries, with the rows. The rows are timed the way the map runs them every frame: positions
+	// gathered from real actors, integrated one or four at a time, then written back to the actors
+	const int NUM_REPEATS = 100;
+	const float DELTA_SECONDS = 1.f / 60.f;
+
+	struct ActorLikeBody
+	{
+		Vec3 m_position;
+		Vec3 m_velocity;
+		Vec3 m_acceleration;
+		float m_dragForce = 9.f;
+		unsigned char m_otherActorState[512] = {};
+	};
+
+	std::vector<std::unique_ptr<ActorLikeBody>> bodies;
+	std::vector<std::unique_ptr<Actor>> ownedActors;
+	std::vector<Actor*> actors;
+	ActorPhysicsSystem physics;
+	for (int row = 0; row < numRows; row++)
+	{
+		bodies.push_back(std::make_unique<ActorLikeBody>());
+		bodies.back()->m_position = Vec3(g_rng.RollRandomFloatInRange(0.f, 64.f), g_rng.RollRandomFloatInRange(0.f, 64.f), 0.f);
+
+		ownedActors.push_back(std::make_unique<Actor>());
+		Actor* actor = ownedActors.back().get();
+		actor->m_position = bodies.back()->m_position;
+		actor->m_isMoveable = true;
+		actor->m_dragForce = bodies.back()->m_dragForce;
+		actors.push_back(actor);
+		physics.AddRow(actor->m_dragForce);
+	}
+
+	auto objectStart = std::chrono::high_resolution_clock::now();
+	for (int repeat = 0; repeat < NUM_REPEATS; repeat++)
+	{
+		for (std::unique_ptr<ActorLikeBody>& body : bodies)
+		{
+			body->m_acceleration += Vec3(1.f, 0.f, 0.f) * body->m_dragForce;
+			body->m_acceleration += -body->m_velocity * body->m_dragForce;
+			body->m_velocity += body->m_acceleration * DELTA_SECONDS * 0.5f;
+			body->m_position += body->m_velocity * DELTA_SECONDS;
+			body->m_velocity += body->m_acceleration * DELTA_SECONDS * 0.5f;
+			body->m_acceleration = Vec3::ZERO;
+		}
+	}
+	auto objectEnd = std::chrono::high_resolution_clock::now();
+
+	auto scalarStart = std::chrono::high_resolution_clock::now();
+	for (int repeat = 0; repeat < NUM_REPEATS; repeat++)
+	{
+		for (int row = 0; row < numRows; row++)
+		{
+			physics.AddForce(row, Vec3(1.f, 0.f, 0.f));
+		}
+		physics.GatherActors(actors, 0, numRows);
+		physics.IntegrateScalar(0, physics.m_numRows, DELTA_SECONDS);
+		physics.ScatterActors(actors, 0, numRows);
+	}
+	auto scalarEnd = std::chrono::high_resolution_clock::now();
+
+	float integrateSeconds = 0.f;
+	auto vectorStart = std::chrono::high_resolution_clock::now();
+	for (int repeat = 0; repeat < NUM_REPEATS; repeat++)
+	{
+		for (int row = 0; row < numRows; row++)
+		{
+			physics.AddForce(row, Vec3(1.f, 0.f, 0.f));
+		}
+		physics.GatherActors(actors, 0, numRows);
+		auto integrateStart = std::chrono::high_resolution_clock::now();
+		physics.Integrate(0, numRows, DELTA_SECONDS);
+		auto integrateEnd = std::chrono::high_resolution_clock::now();
+		physics.ScatterActors(actors, 0, numRows);
+		integrateSeconds += std::chrono::duration<float>(integrateEnd - integrateStart).count();
+	}
+	auto vectorEnd = std::chrono::high_resolution_clock::now();
+
+	float objectMS = std::chrono::duration<float, std::milli>(objectEnd - objectStart).count() / NUM_REPEATS;
+	float scalarMS = std::chrono::duration<float, std::milli>(scalarEnd - scalarStart).count() / NUM_REPEATS;
+	float vectorMS = std::chrono::duration<float, std::milli>(vectorEnd - vectorStart).count() / NUM_REPEATS;
+	float integrateMS = integrateSeconds * 1000.f / NUM_REPEATS;
+	outLines.push_back(Stringf("Actor physics benchmark, %d bodies, average of %d steps", numRows, NUM_REPEATS));
+	outLines.push_back(Stringf("   per actor objects: %.4f ms", objectMS));
+	outLines.push_back(Stringf("   rows with gather and scatter, one at a time: %.4f ms", scalarMS));
+#ifdef ACTOR_PHYSICS_USE_SSE
+	outLines.push_back(Stringf("   rows with gather and scatter, four at a time: %.4f ms (%.4f ms of it integrating)", vectorMS, integrateMS));
+#else
+	outLines.push_back(Stringf("   rows with gather and scatter, four at a time: %.4f ms (%.4f ms of it integrating, no SSE on this target, same loop as above)", vectorMS, integrateMS));
+#endif
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+#include <string>
+#include <chrono>
+
+class Actor;
+
+// Velocity, acceleration and drag of every live actor in flat arrays, one row per actor in the same
+// order as Map::m_actors. Forces and impulses are written straight into the rows and the whole map is
+// integrated in one pass, four rows at a time. Positions still live on the actors since most systems
+// read and write them directly, so they are gathered before the pass and written back after it.
+// The pass can be split across threads as long as every slice starts on a multiple of four rows.
+class ActorPhysicsSystem
+{
+public:
+	ActorPhysicsSystem() = default;
+	~ActorPhysicsSystem() = default;
+
+	void Clear();
+	void AddRow(float drag);
+	void RemoveRow(int row); // Moves the last row into the hole, matching how Map removes from m_actors
+
+	void AddForce(int row, const Vec3& force);
+	void AddImpulse(int row, const Vec3& impulse);
+	Vec3 GetVelocity(int row) const;
+
+	void BeginUpdate();
+	void UpdateRows(std::vector<Actor*>& actors, int firstRow, int lastRow, float deltaSeconds);
+	void EndUpdate();
+
+	int GetNumRows() const;
+	int GetNumSimulatedRows() const;
+	float GetLastUpdateMS() const;
+
+	static void RunBenchmark(int numRows, std::vector<std::string>& outLines);
+
+private:
+	void GatherActors(const std::vector<Actor*>& actors, int firstRow, int lastRow);
+	void Integrate(int firstRow, int lastRow, float deltaSeconds);
+	void IntegrateScalar(int firstRow, int lastRow, float deltaSeconds);
+	void ScatterActors(std::vector<Actor*>& actors, int firstRow, int lastRow) const;
+	void ResizeRows(int numRows);
+
+private:
+	int m_numRows = 0;
+	int m_numSimulatedRows = 0;
+	float m_lastUpdateMS = 0.f;
+	std::chrono::high_resolution_clock::time_point m_updateStart;
+
+	// Rows are padded to a multiple of four, padding rows are never simulated
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	std::vector<float> m_velocityZ;
+	std::vector<float> m_accelerationX;
+	std::vector<float> m_accelerationY;
+	std::vector<float> m_accelerationZ;
+	std::vector<float> m_drag;
+	std::vector<unsigned int> m_simulatedMask; // All bits set for rows integrated this frame
+	std::vector<unsigned char> m_isFlying;
+};
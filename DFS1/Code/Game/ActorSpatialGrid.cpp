@@ -0,0 +1,369 @@
+#include "Game/ActorSpatialGrid.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+void ActorSpatialGrid::Initialize(const IntVec2& mapDimensions, int cellSize)
+{
+	m_cellSize = cellSize > 0 ? cellSize : 1;
+	m_gridDimensions = IntVec2((mapDimensions.x + m_cellSize - 1) / m_cellSize, (mapDimensions.y + m_cellSize - 1) / m_cellSize);
+	m_gridDimensions = IntVec2(std::max(m_gridDimensions.x, 1), std::max(m_gridDimensions.y, 1));
+	Clear();
+}
+
+void ActorSpatialGrid::Clear()
+{
+	m_entries.clear();
+	m_cells.clear();
+	m_cells.resize(static_cast<size_t>(m_gridDimensions.x) * m_gridDimensions.y);
+	m_maxRadius = 0.f;
+	m_numEntries = 0;
+	m_numCellChanges = 0;
+}
+
+void ActorSpatialGrid::InsertEntry(unsigned int entryID, const Vec2& position, float radius)
+{
+	if (entryID >= m_entries.size())
+	{
+		m_entries.resize(entryID + 1);
+	}
+	if (m_entries[entryID].m_cellIndex >= 0)
+	{
+		RemoveFromCell(entryID);
+		m_numEntries--;
+	}
+
+	// Queries widen by the largest radius seen so far, it is never shrunk
+	m_maxRadius = std::max(m_maxRadius, radius);
+	Entry& entry = m_entries[entryID];
+	entry.m_position = position;
+	entry.m_radius = radius;
+	AddToCell(entryID, GetCellIndexForPosition(position));
+	m_numEntries++;
+}
+
+void ActorSpatialGrid::UpdateEntry(unsigned int entryID, const Vec2& position)
+{
+	if (entryID >= m_entries.size() || m_entries[entryID].m_cellIndex < 0)
+	{
+		return;
+	}
+
+	m_entries[entryID].m_position = position;
+	int cellIndex = GetCellIndexForPosition(position);
+	if (cellIndex != m_entries[entryID].m_cellIndex)
+	{
+		RemoveFromCell(entryID);
+		AddToCell(entryID, cellIndex);
+		m_numCellChanges++;
+	}
+}
+
+void ActorSpatialGrid::RemoveEntry(unsigned int entryID)
+{
+	if (entryID >= m_entries.size() || m_entries[entryID].m_cellIndex < 0)
+	{
+		return;
+	}
+	RemoveFromCell(entryID);
+	m_numEntries--;
+}
+
+void ActorSpatialGrid::QueryRadius(const Vec2& center, float radius, std::vector<unsigned int>& outEntryIDs) const
+{
+	outEntryIDs.clear();
+	float reach = radius + m_maxRadius;
+	int minCellX = std::clamp(RoundDownToInt((center.x - reach) / static_cast<float>(m_cellSize)), 0, m_gridDimensions.x - 1);
+	int minCellY = std::clamp(RoundDownToInt((center.y - reach) / static_cast<float>(m_cellSize)), 0, m_gridDimensions.y - 1);
+	int maxCellX = std::clamp(RoundDownToInt((center.x + reach) / static_cast<float>(m_cellSize)), 0, m_gridDimensions.x - 1);
+	int maxCellY = std::clamp(RoundDownToInt((center.y + reach) / static_cast<float>(m_cellSize)), 0, m_gridDimensions.y - 1);
+
+	for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+	{
+		for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+		{
+			for (unsigned int entryID : m_cells[cellX + cellY * m_gridDimensions.x])
+			{
+				const Entry& entry = m_entries[entryID];
+				float touchDistance = radius + entry.m_radius;
+				if (GetDistanceSquared2D(center, entry.m_position) <= touchDistance * touchDistance)
+				{
+					outEntryIDs.push_back(entryID);
+				}
+			}
+		}
+	}
+}
+
+void ActorSpatialGrid::GatherOverlappingPairs(std::vector<std::pair<unsigned int, unsigned int>>& outPairs) const
+{
+	outPairs.clear();
+
+	// Each cell is paired with itself and the cells ahead of it, so every pair of cells is visited once
+	int reach = GetCellReach(2.f * m_maxRadius);
+	for (int cellY = 0; cellY < m_gridDimensions.y; cellY++)
+	{
+		for (int cellX = 0; cellX < m_gridDimensions.x; cellX++)
+		{
+			const std::vector<unsigned int>& cell = m_cells[cellX + cellY * m_gridDimensions.x];
+			if (cell.empty())
+			{
+				continue;
+			}
+
+			for (int offsetY = 0; offsetY <= reach; offsetY++)
+			{
+				int otherY = cellY + offsetY;
+				if (otherY >= m_gridDimensions.y)
+				{
+					break;
+				}
+				for (int offsetX = -reach; offsetX <= reach; offsetX++)
+				{
+					int otherX = cellX + offsetX;
+					if (otherX < 0 || otherX >= m_gridDimensions.x || (offsetY == 0 && offsetX < 0))
+					{
+						continue;
+					}
+
+					bool isSameCell = offsetX == 0 && offsetY == 0;
+					const std::vector<unsigned int>& otherCell = m_cells[otherX + otherY * m_gridDimensions.x];
+					for (size_t indexA = 0; indexA < cell.size(); indexA++)
+					{
+						const Entry& entryA = m_entries[cell[indexA]];
+						for (size_t indexB = isSameCell ? indexA + 1 : 0; indexB < otherCell.size(); indexB++)
+						{
+							const Entry& entryB = m_entries[otherCell[indexB]];
+							float touchDistance = entryA.m_radius + entryB.m_radius;
+							if (GetDistanceSquared2D(entryA.m_position, entryB.m_position) <= touchDistance * touchDistance)
+							{
+								outPairs.push_back(std::make_pair(cell[indexA], otherCell[indexB]));
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void ActorSpatialGrid::GatherRayCandidates(const Vec2& start, const Vec2& direction, float distance, std::vector<unsigned int>& outEntryIDs) const
+{
+	// Walks the cells under the ray's XY shadow and collects every entry within reach of one of them.
+	// The direction does not have to be unit length in XY, only the shadow of the 3D ray is walked
+	outEntryIDs.clear();
+	float cellSize = static_cast<float>(m_cellSize);
+	int reach = GetCellReach(m_maxRadius);
+
+	int cellX = RoundDownToInt(start.x / cellSize);
+	int cellY = RoundDownToInt(start.y / cellSize);
+	int stepX = direction.x >= 0.f ? 1 : -1;
+	int stepY = direction.y >= 0.f ? 1 : -1;
+	float distPerCellX = fabsf(direction.x) > 0.00001f ? cellSize / fabsf(direction.x) : distance + 1.f;
+	float distPerCellY = fabsf(direction.y) > 0.00001f ? cellSize / fabsf(direction.y) : distance + 1.f;
+	float nextCrossingX = fabsf(direction.x) > 0.00001f ? (static_cast<float>(stepX > 0 ? cellX + 1 : cellX) * cellSize - start.x) / direction.x : distance + 1.f;
+	float nextCrossingY = fabsf(direction.y) > 0.00001f ? (static_cast<float>(stepY > 0 ? cellY + 1 : cellY) * cellSize - start.y) / direction.y : distance + 1.f;
+
+	while (true)
+	{
+		int minCellX = std::clamp(cellX - reach, 0, m_gridDimensions.x - 1);
+		int maxCellX = std::clamp(cellX + reach, 0, m_gridDimensions.x - 1);
+		int minCellY = std::clamp(cellY - reach, 0, m_gridDimensions.y - 1);
+		int maxCellY = std::clamp(cellY + reach, 0, m_gridDimensions.y - 1);
+		for (int gatherY = minCellY; gatherY <= maxCellY; gatherY++)
+		{
+			for (int gatherX = minCellX; gatherX <= maxCellX; gatherX++)
+			{
+				const std::vector<unsigned int>& cell = m_cells[gatherX + gatherY * m_gridDimensions.x];
+				outEntryIDs.insert(outEntryIDs.end(), cell.begin(), cell.end());
+			}
+		}
+
+		if (nextCrossingX > distance && nextCrossingY > distance)
+		{
+			break;
+		}
+		if (nextCrossingX < nextCrossingY)
+		{
+			cellX += stepX;
+			nextCrossingX += distPerCellX;
+		}
+		else
+		{
+			cellY += stepY;
+			nextCrossingY += distPerCellY;
+		}
+	}
+
+	// Neighborhoods of consecutive cells overlap, so the same entry is usually collected more than once
+	std::sort(outEntryIDs.begin(), outEntryIDs.end());
+	outEntryIDs.erase(std::unique(outEntryIDs.begin(), outEntryIDs.end()), outEntryIDs.end());
+}
+
+int ActorSpatialGrid::GetNumEntries() const
+{
+	return m_numEntries;
+}
+
+int ActorSpatialGrid::GetNumCellChanges() const
+{
+	return m_numCellChanges;
+}
+
+int ActorSpatialGrid::GetCellIndexForPosition(const Vec2& position) const
+{
+	int cellX = std::clamp(RoundDownToInt(position.x / static_cast<float>(m_cellSize)), 0, m_gridDimensions.x - 1);
+	int cellY = std::clamp(RoundDownToInt(position.y / static_cast<float>(m_cellSize)), 0, m_gridDimensions.y - 1);
+	return cellX + cellY * m_gridDimensions.x;
+}
+
+void ActorSpatialGrid::AddToCell(unsigned int entryID, int cellIndex)
+{
+	std::vector<unsigned int>& cell = m_cells[cellIndex];
+	m_entries[entryID].m_cellIndex = cellIndex;
+	m_entries[entryID].m_indexInCell = static_cast<int>(cell.size());
+	cell.push_back(entryID);
+}
+
+void ActorSpatialGrid::RemoveFromCell(unsigned int entryID)
+{
+	// Swap with the last entry of the cell so removal does not shift the rest
+	Entry& entry = m_entries[entryID];
+	std::vector<unsigned int>& cell = m_cells[entry.m_cellIndex];
+	unsigned int movedID = cell.back();
+	cell[entry.m_indexInCell] = movedID;
+	m_entries[movedID].m_indexInCell = entry.m_indexInCell;
+	cell.pop_back();
+
+	entry.m_cellIndex = -1;
+	entry.m_indexInCell = -1;
+}
+
+int ActorSpatialGrid::GetCellReach(float distance) const
+{
+	return static_cast<int>(ceilf(distance / static_cast<float>(m_cellSize)));
+}
+
+STATIC void ActorSpatialGrid::RunBenchmark(const IntVec2& mapDimensions, int cellSize, std::vector<std::string>& outLines)
+{
+	// Random discs spread over the map, the same scatter is handed to the pair loop and the grid.
+	// Grid timings include inserting every disc, which is the worst case; in game only moved actors pay
+	const int NUM_REPEATS = 20;
+	const float RADIUS = 0.35f;
+	const int agentCounts[] = { 8, 16, 32, 64, 128, 256, 512, 1024, 2048 };
+
+	outLines.push_back(Stringf("Actor grid benchmark on %dx%d tiles, %d tile cells, radius %.2f", mapDimensions.x, mapDimensions.y, cellSize, RADIUS));
+	outLines.push_back("   actors |  brute pairs ms |  grid pairs ms |  brute rays ms |  grid rays ms");
+
+	int pairCrossover = -1;
+	int rayCrossover = -1;
+	ActorSpatialGrid grid;
+	std::vector<Vec2> positions;
+	std::vector<std::pair<unsigned int, unsigned int>> pairs;
+	std::vector<unsigned int> candidates;
+	for (int numAgents : agentCounts)
+	{
+		positions.resize(numAgents);
+		for (Vec2& position : positions)
+		{
+			position = Vec2(g_rng.RollRandomFloatInRange(0.f, static_cast<float>(mapDimensions.x)), g_rng.RollRandomFloatInRange(0.f, static_cast<float>(mapDimensions.y)));
+		}
+
+		int brutePairs = 0;
+		auto bruteStart = std::chrono::high_resolution_clock::now();
+		for (int repeat = 0; repeat < NUM_REPEATS; repeat++)
+		{
+			for (int indexA = 0; indexA < numAgents; indexA++)
+			{
+				for (int indexB = indexA + 1; indexB < numAgents; indexB++)
+				{
+					if (GetDistanceSquared2D(positions[indexA], positions[indexB]) <= 4.f * RADIUS * RADIUS)
+					{
+						brutePairs++;
+					}
+				}
+			}
+		}
+		auto bruteEnd = std::chrono::high_resolution_clock::now();
+
+		int gridPairs = 0;
+		auto gridStart = std::chrono::high_resolution_clock::now();
+		for (int repeat = 0; repeat < NUM_REPEATS; repeat++)
+		{
+			grid.Initialize(mapDimensions, cellSize);
+			for (int index = 0; index < numAgents; index++)
+			{
+				grid.InsertEntry(static_cast<unsigned int>(index), positions[index], RADIUS);
+			}
+			grid.GatherOverlappingPairs(pairs);
+			gridPairs += static_cast<int>(pairs.size());
+		}
+		auto gridEnd = std::chrono::high_resolution_clock::now();
+
+		// One 10 tile ray per agent, as the perception pass casts; the grid is already built
+		int bruteHits = 0;
+		auto bruteRayStart = std::chrono::high_resolution_clock::now();
+		for (int repeat = 0; repeat < NUM_REPEATS; repeat++)
+		{
+			for (int rayIndex = 0; rayIndex < numAgents; rayIndex++)
+			{
+				Vec2 rayStart = positions[rayIndex];
+				Vec2 rayDirection = Vec2(CosDegrees(static_cast<float>(rayIndex * 37)), SinDegrees(static_cast<float>(rayIndex * 37)));
+				for (int index = 0; index < numAgents; index++)
+				{
+					Vec2 toCenter = positions[index] - rayStart;
+					float along = std::clamp(toCenter.x * rayDirection.x + toCenter.y * rayDirection.y, 0.f, 10.f);
+					if (GetDistanceSquared2D(rayStart + rayDirection * along, positions[index]) <= RADIUS * RADIUS)
+					{
+						bruteHits++;
+					}
+				}
+			}
+		}
+		auto bruteRayEnd = std::chrono::high_resolution_clock::now();
+
+		int gridHits = 0;
+		auto gridRayStart = std::chrono::high_resolution_clock::now();
+		for (int repeat = 0; repeat < NUM_REPEATS; repeat++)
+		{
+			for (int rayIndex = 0; rayIndex < numAgents; rayIndex++)
+			{
+				Vec2 rayStart = positions[rayIndex];
+				Vec2 rayDirection = Vec2(CosDegrees(static_cast<float>(rayIndex * 37)), SinDegrees(static_cast<float>(rayIndex * 37)));
+				grid.GatherRayCandidates(rayStart, rayDirection, 10.f, candidates);
+				for (unsigned int index : candidates)
+				{
+					Vec2 toCenter = positions[index] - rayStart;
+					float along = std::clamp(toCenter.x * rayDirection.x + toCenter.y * rayDirection.y, 0.f, 10.f);
+					if (GetDistanceSquared2D(rayStart + rayDirection * along, positions[index]) <= RADIUS * RADIUS)
+					{
+						gridHits++;
+					}
+				}
+			}
+		}
+		auto gridRayEnd = std::chrono::high_resolution_clock::now();
+
+		float brutePairMS = std::chrono::duration<float, std::milli>(bruteEnd - bruteStart).count() / static_cast<float>(NUM_REPEATS);
+		float gridPairMS = std::chrono::duration<float, std::milli>(gridEnd - gridStart).count() / static_cast<float>(NUM_REPEATS);
+		float bruteRayMS = std::chrono::duration<float, std::milli>(bruteRayEnd - bruteRayStart).count() / static_cast<float>(NUM_REPEATS);
+		float gridRayMS = std::chrono::duration<float, std::milli>(gridRayEnd - gridRayStart).count() / static_cast<float>(NUM_REPEATS);
+		if (pairCrossover < 0 && gridPairMS < brutePairMS)
+		{
+			pairCrossover = numAgents;
+		}
+		if (rayCrossover < 0 && gridRayMS < bruteRayMS)
+		{
+			rayCrossover = numAgents;
+		}
+
+		outLines.push_back(Stringf("%9d | %15.4f | %14.4f | %14.4f | %13.4f%s", numAgents, brutePairMS, gridPairMS, bruteRayMS, gridRayMS, (brutePairs != gridPairs || bruteHits != gridHits) ? "  MISMATCH" : ""));
+	}
+
+	outLines.push_back(Stringf("Grid wins from %d actors for collision pairs and from %d actors for rays (-1: never within the tested range)", pairCrossover, rayCrossover));
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include <vector>
+#include <string>
+#include <utility>
+
+// Uniform grid of tile aligned cells holding actor discs, keyed by ActorUID slot index. Entries are
+// moved between cells only when an update takes them across a cell border, so keeping it in sync costs
+// a compare per moved actor. Collision, the actor half of raycasts and radius queries all read from it.
+// Actors outside the map are kept in the nearest edge cell.
+class ActorSpatialGrid
+{
+public:
+	ActorSpatialGrid() = default;
+	~ActorSpatialGrid() = default;
+
+	void Initialize(const IntVec2& mapDimensions, int cellSize);
+	void Clear();
+
+	void InsertEntry(unsigned int entryID, const Vec2& position, float radius);
+	void UpdateEntry(unsigned int entryID, const Vec2& position);
+	void RemoveEntry(unsigned int entryID);
+
+	void QueryRadius(const Vec2& center, float radius, std::vector<unsigned int>& outEntryIDs) const;
+	void GatherOverlappingPairs(std::vector<std::pair<unsigned int, unsigned int>>& outPairs) const;
+	void GatherRayCandidates(const Vec2& start, const Vec2& direction, float distance, std::vector<unsigned int>& outEntryIDs) const;
+
+	int GetNumEntries() const;
+	int GetNumCellChanges() const;
+
+	static void RunBenchmark(const IntVec2& mapDimensions, int cellSize, std::vector<std::string>& outLines);
+
+private:
+	struct Entry
+	{
+		Vec2 m_position;
+		float m_radius = 0.f;
+		int m_cellIndex = -1;
+		int m_indexInCell = -1;
+	};
+
+	int GetCellIndexForPosition(const Vec2& position) const;
+	void AddToCell(unsigned int entryID, int cellIndex);
+	void RemoveFromCell(unsigned int entryID);
+	int GetCellReach(float distance) const;
+
+private:
+	IntVec2 m_gridDimensions = IntVec2::ZERO;
+	int m_cellSize = 1;
+	float m_maxRadius = 0.f;
+	int m_numEntries = 0;
+	int m_numCellChanges = 0;
+	std::vector<Entry> m_entries;
+	std::vector<std::vector<unsigned int>> m_cells;
+};
@@ -1,15 +1,15 @@
 #include "Game/ActorUID.hpp"
 
-const ActorUID ActorUID::INVALID = ActorUID(0xFFFF, 0xFFFF);
+const ActorUID ActorUID::INVALID = ActorUID(0xFFFFFFFFu, 0xFFFFFFFFu);
 
 ActorUID::ActorUID()
 	: m_data(INVALID.m_data)
 {
 }
 
-ActorUID::ActorUID(unsigned int salt, unsigned int index)
+ActorUID::ActorUID(unsigned int generation, unsigned int index)
 {
-	m_data = (salt << 16) | (index & 0xFFFF);
+	m_data = (static_cast<unsigned long long>(generation) << 32) | static_cast<unsigned long long>(index);
 }
 
 bool ActorUID::IsValid() const
@@ -19,7 +19,12 @@ bool ActorUID::IsValid() const
 
 unsigned int ActorUID::GetIndex() const
 {
-	return m_data & 0xFFFF;
+	return static_cast<unsigned int>(m_data & 0xFFFFFFFFull);
+}
+
+unsigned int ActorUID::GetGeneration() const
+{
+	return static_cast<unsigned int>(m_data >> 32);
 }
 
 bool ActorUID::operator==(const ActorUID& other) const
@@ -4,15 +4,16 @@ struct ActorUID
 {
 public:
 	ActorUID();
-	ActorUID(unsigned int salt, unsigned int index);
+	ActorUID(unsigned int generation, unsigned int index);
 
 	bool IsValid() const;
 	unsigned int GetIndex() const;
+	unsigned int GetGeneration() const;
 	bool operator==(const ActorUID& other) const;
 	bool operator!=(const ActorUID& other) const;
 
 	static const ActorUID INVALID;
 
 private:
-	unsigned int m_data;
+	unsigned long long m_data; // Slot generation in the high 32 bits, slot index in the low 32 bits
 };
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "Game/ActorUpdateJob.hpp"
+#include "Game/Map.hpp"
+#include "Game/AIActor.hpp"
+
+ActorUpdateJob::ActorUpdateJob(Map* map, ActorUpdatePhase phase, int firstIndex, int lastIndex, float deltaSeconds)
+	:m_map(map), m_phase(phase), m_firstIndex(firstIndex), m_lastIndex(lastIndex), m_deltaSeconds(deltaSeconds)
+{
+	m_state = JobStatus::NEW;
+}
+
+void ActorUpdateJob::Execute()
+{
+	switch (m_phase)
+	{
+	case ActorUpdatePhase::THINK:
+		for (int aiIndex = m_firstIndex; aiIndex < m_lastIndex; aiIndex++)
+		{
+			m_map->m_thinkingAIs[aiIndex]->Think();
+		}
+		break;
+	case ActorUpdatePhase::INTEGRATE:
+		m_map->m_actorPhysics.UpdateRows(m_map->m_actors, m_firstIndex, m_lastIndex, m_deltaSeconds);
+		break;
+	case ActorUpdatePhase::COLLIDE:
+		for (int islandIndex = m_firstIndex; islandIndex < m_lastIndex; islandIndex++)
+		{
+			m_map->ResolveContactIsland(islandIndex);
+		}
+		break;
+	}
+	m_state = JobStatus::COMPLETED;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Engine/Core/JobSystem.hpp"
+
+class Map;
+
+enum class ActorUpdatePhase
+{
+	THINK,
+	INTEGRATE,
+	COLLIDE
+};
+
+// One slice of a phased actor update. The map splits a phase into slices, queues all but one, runs that
+// one itself and waits for the rest before starting the next phase, so slices only ever run alongside
+// slices of the same phase. Think slices cover Map::m_thinkingAIs, integrate slices cover physics rows,
+// collide slices cover contact islands.
+class ActorUpdateJob : public Job
+{
+public:
+	ActorUpdateJob(Map* map, ActorUpdatePhase phase, int firstIndex, int lastIndex, float deltaSeconds);
+
+	virtual void Execute() override;
+
+public:
+	Map* m_map = nullptr;
+	ActorUpdatePhase m_phase = ActorUpdatePhase::THINK;
+	int m_firstIndex = 0;
+	int m_lastIndex = 0;
+	float m_deltaSeconds = 0.f;
+};
@@ -0,0 +1,125 @@
+#include "Game/AlertWavefront.hpp"
+#include "Game/NavSnapshot.hpp"
+
+void AlertWavefront::Initialize(const IntVec2& dimensions, int radius, float tilesPerSecond)
+{
+	m_dimensions = dimensions;
+	m_radius = radius;
+	m_tilesPerSecond = tilesPerSecond;
+	m_tileSerials.assign(static_cast<size_t>(dimensions.x) * static_cast<size_t>(dimensions.y), 0);
+	m_waves.clear();
+}
+
+unsigned int AlertWavefront::StartWave(const NavSnapshot& navSnapshot, const IntVec2& originTile)
+{
+	if (originTile.x < 0 || originTile.y < 0 || originTile.x >= m_dimensions.x || originTile.y >= m_dimensions.y || navSnapshot.IsSolidTile(originTile.x, originTile.y))
+	{
+		return 0;
+	}
+
+	Wave newWave;
+	newWave.m_serial = m_nextSerial++;
+	StampTile(newWave, originTile, 0);
+	m_waves.push_back(std::move(newWave));
+	return m_waves.back().m_serial;
+}
+
+void AlertWavefront::Update(const NavSnapshot& navSnapshot, float deltaSeconds)
+{
+	static const IntVec2 NEIGHBOR_OFFSETS[4] = { IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1) };
+
+	m_numTilesReachedLastUpdate = 0;
+	for (int waveIndex = 0; waveIndex < static_cast<int>(m_waves.size());)
+	{
+		Wave& wave = m_waves[waveIndex];
+
+		// A wave that ran out of tiles last update stays stamped for one update so AIs on its last ring still see it
+		if (wave.m_nextTileIndex >= wave.m_tiles.size())
+		{
+			ClearStamps(wave);
+			m_waves.erase(m_waves.begin() + waveIndex);
+			continue;
+		}
+
+		wave.m_reach += m_tilesPerSecond * deltaSeconds;
+		size_t numTilesBefore = wave.m_tiles.size();
+
+		// Tiles are expanded in breadth-first order, so stop at the first one the wave has not grown past yet
+		while (wave.m_nextTileIndex < wave.m_tiles.size() && static_cast<float>(wave.m_distances[wave.m_nextTileIndex]) < wave.m_reach)
+		{
+			IntVec2 tileCoords = wave.m_tiles[wave.m_nextTileIndex];
+			int distance = wave.m_distances[wave.m_nextTileIndex];
+			wave.m_nextTileIndex++;
+			if (distance >= m_radius)
+			{
+				continue;
+			}
+
+			for (const IntVec2& offset : NEIGHBOR_OFFSETS)
+			{
+				IntVec2 neighborCoords = tileCoords + offset;
+				if (neighborCoords.x < 0 || neighborCoords.y < 0 || neighborCoords.x >= m_dimensions.x || neighborCoords.y >= m_dimensions.y)
+				{
+					continue;
+				}
+				// Tiles already stamped by this wave or a newer one are left alone
+				if (m_tileSerials[neighborCoords.x + neighborCoords.y * m_dimensions.x] >= wave.m_serial || navSnapshot.IsSolidTile(neighborCoords.x, neighborCoords.y))
+				{
+					continue;
+				}
+				StampTile(wave, neighborCoords, distance + 1);
+			}
+		}
+
+		m_numTilesReachedLastUpdate += static_cast<int>(wave.m_tiles.size() - numTilesBefore);
+		waveIndex++;
+	}
+}
+
+void AlertWavefront::Clear()
+{
+	for (const Wave& wave : m_waves)
+	{
+		ClearStamps(wave);
+	}
+	m_waves.clear();
+}
+
+unsigned int AlertWavefront::GetWaveSerialAtTile(const IntVec2& tileCoords) const
+{
+	if (tileCoords.x < 0 || tileCoords.y < 0 || tileCoords.x >= m_dimensions.x || tileCoords.y >= m_dimensions.y)
+	{
+		return 0;
+	}
+	return m_tileSerials[tileCoords.x + tileCoords.y * m_dimensions.x];
+}
+
+int AlertWavefront::GetNumActiveWaves() const
+{
+	return static_cast<int>(m_waves.size());
+}
+
+int AlertWavefront::GetNumTilesReachedLastUpdate() const
+{
+	return m_numTilesReachedLastUpdate;
+}
+
+void AlertWavefront::StampTile(Wave& wave, const IntVec2& tileCoords, int distance)
+{
+	// Newer waves overwrite older stamps, Update never lets an older wave stamp over a newer one
+	m_tileSerials[tileCoords.x + tileCoords.y * m_dimensions.x] = wave.m_serial;
+	wave.m_tiles.push_back(tileCoords);
+	wave.m_distances.push_back(distance);
+}
+
+void AlertWavefront::ClearStamps(const Wave& wave)
+{
+	for (const IntVec2& tileCoords : wave.m_tiles)
+	{
+		unsigned int& tileSerial = m_tileSerials[tileCoords.x + tileCoords.y * m_dimensions.x];
+		if (tileSerial == wave.m_serial)
+		{
+			tileSerial = 0;
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include <vector>
+
+class NavSnapshot;
+
+// Squad alerts spread as a breadth-first wave over walkable tiles instead of reaching every AI at once.
+// Each wave grows by a fixed number of tiles per second up to its radius, stamping the tiles it covers
+// with its serial. AIs standing on a stamped tile answer the alert the next time they update, so the
+// replans it causes are spread over the frames the wave takes to grow.
+class AlertWavefront
+{
+public:
+	AlertWavefront() = default;
+	~AlertWavefront() = default;
+
+	void Initialize(const IntVec2& dimensions, int radius, float tilesPerSecond);
+	unsigned int StartWave(const NavSnapshot& navSnapshot, const IntVec2& originTile);
+	void Update(const NavSnapshot& navSnapshot, float deltaSeconds);
+	void Clear();
+
+	unsigned int GetWaveSerialAtTile(const IntVec2& tileCoords) const;
+	int GetNumActiveWaves() const;
+	int GetNumTilesReachedLastUpdate() const;
+
+private:
+	struct Wave
+	{
+		unsigned int m_serial = 0;
+		float m_reach = 0.f;
+		size_t m_nextTileIndex = 0;
+		std::vector<IntVec2> m_tiles;
+		std::vector<int> m_distances;
+	};
+
+	void StampTile(Wave& wave, const IntVec2& tileCoords, int distance);
+	void ClearStamps(const Wave& wave);
+
+private:
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	int m_radius = 12;
+	float m_tilesPerSecond = 24.f;
+	unsigned int m_nextSerial = 1;
+	int m_numTilesReachedLastUpdate = 0;
+	std::vector<unsigned int> m_tileSerials;
+	std::vector<Wave> m_waves;
+};
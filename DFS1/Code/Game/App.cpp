@@ -12,6 +12,14 @@
 #include "ThirdParty/TinyXML2/tinyxml2.h"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Renderer/DebugRenderer.hpp"
+#include "Game/Map.hpp"
+#include "Game/ActorSpatialGrid.hpp"
+#include "Game/ActorPhysicsSystem.hpp"
+#include "Game/SweptDiscCollision.hpp"
+#include "Game/TimerWheel.hpp"
+#include "Game/Tile.hpp"
+#include <thread>
+#include <algorithm>
 
 Window*		 g_theWindow   = nullptr;
 App*		 g_theApp      = nullptr;
@@ -49,6 +57,122 @@ STATIC bool App::Event_WindowRestored(EventArgs& args)
 	return false;
 }
 
+STATIC void App::PrintLinesToConsole(const std::vector<std::string>& lines)
+{
+	for (const std::string& line : lines)
+	{
+		g_theConsole->AddLine(Rgba8::LIGHT_BLUE, line);
+	}
+}
+
+STATIC bool App::Event_BenchmarkActorGrid(EventArgs& args)
+{
+	UNUSED(args);
+	// Runs on the current map's dimensions so the numbers match the level being played
+	IntVec2 mapDimensions = IntVec2(64, 64);
+	if (g_theApp->m_game && g_theApp->m_game->m_currentMap)
+	{
+		mapDimensions = g_theApp->m_game->m_currentMap->GetMapDimensions();
+	}
+
+	std::vector<std::string> lines;
+	ActorSpatialGrid::RunBenchmark(mapDimensions, static_cast<int>(g_defaultConfigBlackboard->GetValue("actorGridCellSize", 1.f)), lines);
+	PrintLinesToConsole(lines);
+	return false;
+}
+
+STATIC bool App::Event_BenchmarkActorPhysics(EventArgs& args)
+{
+	UNUSED(args);
+	std::vector<std::string> lines;
+	ActorPhysicsSystem::RunBenchmark(10000, lines);
+	PrintLinesToConsole(lines);
+	return false;
+}
+
+STATIC bool App::Event_ValidateWallSweep(EventArgs& args)
+{
+	UNUSED(args);
+	// Always runs on a grid of scattered tiles for the corners, and on the level being played when there is one
+	std::vector<std::string> lines;
+	SweptDiscCollision::RunRandomGridValidation(20000, lines);
+	Map* currentMap = g_theApp->m_game ? g_theApp->m_game->m_currentMap : nullptr;
+	if (currentMap)
+	{
+		SweptDiscCollision wallSweep(currentMap->GetMapDimensions(), currentMap->m_navSnapshot->GetSolidTiles(), currentMap->m_wallDistance);
+		wallSweep.RunValidation(20000, lines);
+	}
+	PrintLinesToConsole(lines);
+	return false;
+}
+
+STATIC bool App::Event_ValidateWallRaycasts(EventArgs& args)
+{
+	UNUSED(args);
+	Map* currentMap = g_theApp->m_game ? g_theApp->m_game->m_currentMap : nullptr;
+	if (!currentMap)
+	{
+		g_theConsole->AddLine(Rgba8::LIGHT_BLUE, "Wall distance raycasts: no map loaded");
+		return false;
+	}
+
+	std::vector<std::string> lines;
+	currentMap->ValidateWallDistanceRaycasts(100000, lines);
+	PrintLinesToConsole(lines);
+	return false;
+}
+
+STATIC bool App::Event_ValidateContactIslands(EventArgs& args)
+{
+	UNUSED(args);
+	Map* currentMap = g_theApp->m_game ? g_theApp->m_game->m_currentMap : nullptr;
+	if (!currentMap)
+	{
+		g_theConsole->AddLine(Rgba8::LIGHT_BLUE, "Contact islands: no map loaded");
+		return false;
+	}
+
+	std::vector<std::string> lines;
+	currentMap->ValidateContactIslands(lines);
+	PrintLinesToConsole(lines);
+	return false;
+}
+
+STATIC bool App::Event_ValidateTimerWheel(EventArgs& args)
+{
+	UNUSED(args);
+	std::vector<std::string> lines;
+	TimerWheel::RunValidation(lines);
+	PrintLinesToConsole(lines);
+	return false;
+}
+
+STATIC bool App::Event_ToggleTile(EventArgs& args)
+{
+	Map* currentMap = g_theApp->m_game ? g_theApp->m_game->m_currentMap : nullptr;
+	if (!currentMap)
+	{
+		g_theConsole->AddLine(Rgba8::LIGHT_BLUE, "ToggleTile: no map loaded");
+		return false;
+	}
+
+	// Opens or closes one tile at runtime so the nav rebuild, path cache invalidation and wall distance update can be exercised
+	int x = static_cast<int>(args.GetValue("x", -1.f));
+	int y = static_cast<int>(args.GetValue("y", -1.f));
+	const Tile* tile = currentMap->GetTile(x, y);
+	if (!tile)
+	{
+		g_theConsole->AddLine(Rgba8::LIGHT_BLUE, Stringf("ToggleTile: (%d, %d) is outside the map", x, y));
+		return false;
+	}
+
+	bool isSolid = tile->GetTileDefinition()->m_isSolid;
+	const TileDefinition* newTileDef = TileDefinition::GetTileDefByName(isSolid ? "Ground" : "InteriorWall");
+	currentMap->SetTileDefinition(IntVec2(x, y), newTileDef);
+	g_theConsole->AddLine(Rgba8::LIGHT_BLUE, Stringf("ToggleTile: (%d, %d) is now %s", x, y, newTileDef->m_name.c_str()));
+	return false;
+}
+
 App::~App()
 {
 }
@@ -58,7 +182,14 @@ void App::Startup()
 	LoadGameData();
 
 	JobSystemConfig jobSystemConfig;
-	jobSystemConfig.m_numWorkers = -1;
+	// Resolved here rather than left to the job system so the map can slice its work to the exact worker count
+	int numJobWorkers = static_cast<int>(g_defaultConfigBlackboard->GetValue("numJobWorkers", -1.f));
+	if (numJobWorkers < 0)
+	{
+		numJobWorkers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+	}
+	jobSystemConfig.m_numWorkers = numJobWorkers;
+	m_numJobWorkers = numJobWorkers;
 	g_theJobSystem = new JobSystem(jobSystemConfig);
 
 	EventSystemConfig eventConfig;
@@ -100,6 +231,13 @@ void App::Startup()
 	SubscribeEventCallbackFunction("WindowMinimized", App::Event_WindowMinimized);
 	SubscribeEventCallbackFunction("WindowMaximized", App::Event_WindowMaximized);
 	SubscribeEventCallbackFunction("WindowRestored", App::Event_WindowRestored);
+	SubscribeEventCallbackFunction("BenchmarkActorGrid", App::Event_BenchmarkActorGrid);
+	SubscribeEventCallbackFunction("BenchmarkActorPhysics", App::Event_BenchmarkActorPhysics);
+	SubscribeEventCallbackFunction("ValidateWallSweep", App::Event_ValidateWallSweep);
+	SubscribeEventCallbackFunction("ValidateWallRaycasts", App::Event_ValidateWallRaycasts);
+	SubscribeEventCallbackFunction("ValidateContactIslands", App::Event_ValidateContactIslands);
+	SubscribeEventCallbackFunction("ValidateTimerWheel", App::Event_ValidateTimerWheel);
+	SubscribeEventCallbackFunction("ToggleTile", App::Event_ToggleTile);
 	g_theConsole->Startup();
 	g_theInput->Startup();
 	g_theWindow->Startup();
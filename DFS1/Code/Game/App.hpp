@@ -2,6 +2,8 @@
 #include "Engine/Core/EventSystem.hpp"
 #include <cstdlib>
 #include <bitset>
+#include <string>
+#include <vector>
 
 class Game;
 class Clock;
@@ -10,6 +12,7 @@ class App
 {
 public:
 	Game* m_game = nullptr;
+	int m_numJobWorkers = 0;
 public:
 	App() = default; // Construction
 	~App(); // Destruction
@@ -27,6 +30,14 @@ public:
 	static bool Event_WindowMinimized(EventArgs& args);
 	static bool Event_WindowMaximized(EventArgs& args);
 	static bool Event_WindowRestored(EventArgs& args);
+	static bool Event_BenchmarkActorGrid(EventArgs& args);
+	static bool Event_BenchmarkActorPhysics(EventArgs& args);
+	static bool Event_ValidateWallSweep(EventArgs& args);
+	static bool Event_ValidateWallRaycasts(EventArgs& args);
+	static bool Event_ValidateContactIslands(EventArgs& args);
+	static bool Event_ValidateTimerWheel(EventArgs& args);
+	static bool Event_ToggleTile(EventArgs& args);
+	static void PrintLinesToConsole(const std::vector<std::string>& lines);
 
 private:
 	void BeginFrame();
@@ -12,6 +12,11 @@ Controller::~Controller()
 {
 }
 
+void Controller::UpdateStep()
+{
+	Update();
+}
+
 void Controller::Possess(Actor* newActor)
 {
 	Actor* currentActor = GetActor();
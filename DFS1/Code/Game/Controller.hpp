@@ -17,6 +17,7 @@ public:
 	virtual ~Controller();
 
 	virtual void Update() = 0;
+	virtual void UpdateStep(); // Called by the possessed actor on every simulation step, defaults to Update
 
 	void Possess(Actor* newActor);
 	Actor* GetActor() const;
@@ -0,0 +1,59 @@
+#include "Game/FrameVisibilityCache.hpp"
+
+bool FrameVisibilityCache::TryGetVisibility(const ActorUID& observerUID, const ActorUID& targetUID, bool& outIsVisible)
+{
+	auto found = m_entries.find(MakeKey(observerUID, targetUID));
+	if (found == m_entries.end())
+	{
+		m_misses++;
+		return false;
+	}
+
+	outIsVisible = found->second;
+	m_hits++;
+	return true;
+}
+
+void FrameVisibilityCache::StoreVisibility(const ActorUID& observerUID, const ActorUID& targetUID, bool isVisible)
+{
+	m_entries[MakeKey(observerUID, targetUID)] = isVisible;
+}
+
+void FrameVisibilityCache::Clear()
+{
+	// Keep the finished frame's numbers around for the debug overlay
+	m_lastFrameStats.m_hits = m_hits;
+	m_lastFrameStats.m_misses = m_misses;
+	m_lastFrameStats.m_numEntries = static_cast<unsigned int>(m_entries.size());
+
+	m_entries.clear();
+	m_hits = 0;
+	m_misses = 0;
+}
+
+FrameVisibilityStats FrameVisibilityCache::GetStats() const
+{
+	return m_lastFrameStats;
+}
+
+bool FrameVisibilityCache::Key::operator==(const Key& other) const
+{
+	return m_observerUID == other.m_observerUID && m_targetUID == other.m_targetUID;
+}
+
+size_t FrameVisibilityCache::KeyHasher::operator()(const Key& key) const
+{
+	size_t hash = static_cast<size_t>(key.m_observerUID.GetIndex());
+	hash = (hash * 31) ^ static_cast<size_t>(key.m_observerUID.GetGeneration());
+	hash = (hash * 31) ^ static_cast<size_t>(key.m_targetUID.GetIndex());
+	hash = (hash * 31) ^ static_cast<size_t>(key.m_targetUID.GetGeneration());
+	return hash;
+}
+
+FrameVisibilityCache::Key FrameVisibilityCache::MakeKey(const ActorUID& observerUID, const ActorUID& targetUID) const
+{
+	Key key;
+	key.m_observerUID = observerUID;
+	key.m_targetUID = targetUID;
+	return key;
+}
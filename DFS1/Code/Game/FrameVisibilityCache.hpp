@@ -0,0 +1,49 @@
+#pragma once
+#include "Game/ActorUID.hpp"
+#include <unordered_map>
+#include <cstddef>
+
+struct FrameVisibilityStats
+{
+	unsigned int m_hits = 0;
+	unsigned int m_misses = 0;
+	unsigned int m_numEntries = 0;
+};
+
+// Line of sight answers for the current frame, keyed on (observer, target). Map::MapUpdate clears it
+// at the start of every frame, so within a frame each pair only ever casts its rays once
+class FrameVisibilityCache
+{
+public:
+	FrameVisibilityCache() = default;
+	~FrameVisibilityCache() = default;
+
+	bool TryGetVisibility(const ActorUID& observerUID, const ActorUID& targetUID, bool& outIsVisible);
+	void StoreVisibility(const ActorUID& observerUID, const ActorUID& targetUID, bool isVisible);
+	void Clear();
+
+	FrameVisibilityStats GetStats() const;
+
+private:
+	// Whole UIDs, generation included, so an actor spawned into a freed slot never picks up the old occupant's answer
+	struct Key
+	{
+		ActorUID m_observerUID;
+		ActorUID m_targetUID;
+
+		bool operator==(const Key& other) const;
+	};
+
+	struct KeyHasher
+	{
+		size_t operator()(const Key& key) const;
+	};
+
+	Key MakeKey(const ActorUID& observerUID, const ActorUID& targetUID) const;
+
+private:
+	std::unordered_map<Key, bool, KeyHasher> m_entries;
+	unsigned int m_hits = 0;
+	unsigned int m_misses = 0;
+	FrameVisibilityStats m_lastFrameStats;
+};
@@ -117,6 +117,7 @@ void Game::UpdateLobby()
 
 void Game::UpdateTimeRemaining()
 {
+	const RenderSnapshot& snapshot = m_currentMap->GetRenderSnapshot();
 	float deltaSeconds = m_clock->GetDeltaSeconds();
 
 	// Update the lerp factor
@@ -143,7 +144,7 @@ void Game::UpdateTimeRemaining()
 
 	// Determine the current color based on the lerp factor
 	Rgba8 timeRemainingColor;
-	if (m_currentMap->m_gameTime <= 10.f)
+	if (snapshot.m_gameTime <= 10.f)
 	{
 		float currentR = Interpolate(m_timerStartColor.r, m_timerEndColor.r, m_timerLerpFactor);
 		float currentG = Interpolate(m_timerStartColor.g, m_timerEndColor.g, m_timerLerpFactor);
@@ -153,20 +154,13 @@ void Game::UpdateTimeRemaining()
 		timeRemainingColor = currentColor;
 	}
 
-	if (m_currentMap->m_didAddTime)
+	if (snapshot.m_didAddTime)
 	{
 		std::string addedTimeText = Stringf("+5.00");
 		DebugAddScreenText(addedTimeText, Vec2((float)g_theWindow->GetClientDimensions().x - 880.f, (float)g_theWindow->GetClientDimensions().y - 30.f), 20.f, Vec2(0.5f, 0.5f), 0.f, Rgba8::GREEN, Rgba8::GREEN);
-
-		m_currentMap->m_addTimeShow -= deltaSeconds;
-		if (m_currentMap->m_addTimeShow <= 0.f)
-		{
-			m_currentMap->m_didAddTime = false;
-			m_currentMap->m_addTimeShow = 1.f;
-		}
 	}
 
-	std::string timerPosText = Stringf("Time Remaining: %.2f", m_currentMap->m_gameTime);
+	std::string timerPosText = Stringf("Time Remaining: %.2f", snapshot.m_gameTime);
 	DebugAddScreenText(timerPosText, Vec2((float)g_theWindow->GetClientDimensions().x - 1200.f, (float)g_theWindow->GetClientDimensions().y - 50.f), 20.f, Vec2(0.5f, 0.5f), 0.f, timeRemainingColor, timeRemainingColor);
 }
 
@@ -358,6 +352,8 @@ void Game::RenderAttract()
 
 void Game::RenderPlaying()
 {
+	// Everything below reads the published snapshot, the simulation may be running the next frame meanwhile
+	const RenderSnapshot& snapshot = m_currentMap->GetRenderSnapshot();
 	std::vector<Vertex_PCU> verts;
 
 	if (m_player)
@@ -371,7 +367,7 @@ void Game::RenderPlaying()
 
 		g_theRenderer->BeginCamera(*m_uiScreenView);
 
-		std::string numEnemiesText = Stringf("Num Enemies: %d", m_currentMap->m_numEnemyActors.size());
+		std::string numEnemiesText = Stringf("Num Enemies: %d", snapshot.m_numEnemies);
 		DebugAddScreenText(numEnemiesText, Vec2((float)g_theWindow->GetClientDimensions().x - 1900.f, (float)g_theWindow->GetClientDimensions().y - 45.f), 15.f, Vec2(0.5f, 0.5f), 0.f, Rgba8::LIGHT_RED, Rgba8::LIGHT_RED);
 
 		if (m_player->m_currentCameraMode == CameraMode::MAP)
@@ -379,9 +375,9 @@ void Game::RenderPlaying()
 			std::string debugText = Stringf("%s", m_player->m_isShowingDebugOptions ? "Press F9 to disable debug keys" : "Press F9 to enable debug keys");
 			DebugAddScreenText(debugText, Vec2((float)g_theWindow->GetClientDimensions().x - 1900.f, (float)g_theWindow->GetClientDimensions().y - 60.f), 15.f, Vec2(0.5f, 0.5f), 0.f, Rgba8::WHITE, Rgba8::WHITE);
 			
-			if (m_player->GetActor() != nullptr)
+			if (snapshot.m_hasPlayerActor)
 			{
-				std::string playerHealthInfo = Stringf("Player actor health value: %d", m_player->GetActor()->m_health);
+				std::string playerHealthInfo = Stringf("Player actor health value: %d", snapshot.m_playerHealth);
 				DebugAddScreenText(playerHealthInfo, Vec2((float)g_theWindow->GetClientDimensions().x - 1900.f, (float)g_theWindow->GetClientDimensions().y - 30.f), 15.f, Vec2(0.5f, 0.5f), 0.f, Rgba8::LIGHT_ORANGE, Rgba8::LIGHT_ORANGE);
 			}
 
@@ -392,6 +388,11 @@ void Game::RenderPlaying()
 
 				std::string aiGoalPositionEnabledText = Stringf("%s", m_currentMap->m_canSeeAiGoalPosition ? "Press F3 to disable AI Goal Position view" : "Press F3 to enable AI Goal Position view");
 				DebugAddScreenText(aiGoalPositionEnabledText, Vec2((float)g_theWindow->GetClientDimensions().x - 1900.f, (float)g_theWindow->GetClientDimensions().y - 105.f), 15.f, Vec2(0.5f, 0.5f), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+
+				for (const SnapshotScreenText& overlayLine : snapshot.m_debugOverlayLines)
+				{
+					DebugAddScreenText(overlayLine.m_text, Vec2((float)g_theWindow->GetClientDimensions().x - 1900.f, (float)g_theWindow->GetClientDimensions().y - overlayLine.m_offsetFromTop), 15.f, Vec2(0.5f, 0.5f), 0.f, overlayLine.m_color, overlayLine.m_color);
+				}
 			}
 		}
 
@@ -403,15 +404,17 @@ void Game::RenderPlaying()
 
 	g_theRenderer->EndCamera(*m_uiScreenView);
 
-	if (m_currentMap->m_hasPlayerReachedGoal && m_currentMap->m_gameTime > 0.f)
+	if (snapshot.m_hasPlayerReachedGoal && snapshot.m_gameTime > 0.f)
 	{
 		RenderWinScreenUI();
 	}
 
-	if (m_currentMap->m_gameTime <= 0.f || m_currentMap->GetPlayerActor() == nullptr)
+	if (snapshot.m_gameTime <= 0.f || !snapshot.m_hasPlayerActor)
 	{
 		RenderLoseScreenUI();
 	}
+
+	m_currentMap->WaitForSimulation();
 }
 
 void Game::Render()
@@ -465,7 +468,13 @@ void Game::EnterPlaying()
 	TileDefinition::InitializeTileDefs();
 	MapDefinition::InitializeMapDef();
 
-	g_rng.SetSeed(static_cast<unsigned int>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
+	// A non-zero seed in the config replaces the time based one, every AI seeds its own generator from this one
+	unsigned int randomSeed = static_cast<unsigned int>(g_defaultConfigBlackboard->GetValue("randomSeed", 0.f));
+	if (randomSeed == 0)
+	{
+		randomSeed = static_cast<unsigned int>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+	}
+	g_rng.SetSeed(randomSeed);
 	m_randomMapSelection = g_rng.SRollRandomIntInRange(1, 3);
 	if (m_randomMapSelection == 1)
 	{
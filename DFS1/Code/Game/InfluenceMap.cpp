@@ -0,0 +1,316 @@
+#include "Game/InfluenceMap.hpp"
+#include "Game/Map.hpp"
+#include "Game/Actor.hpp"
+#include "Game/AIActor.hpp"
+#include "Game/TileVisibilitySet.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define INFLUENCE_USE_SSE
+#endif
+
+InfluenceDiffusionJob::InfluenceDiffusionJob(unsigned int mapID, std::shared_ptr<InfluenceGrid> grid)
+	:m_mapID(mapID), m_grid(grid)
+{
+	m_state = JobStatus::NEW;
+}
+
+void InfluenceDiffusionJob::Execute()
+{
+	auto executeStart = std::chrono::high_resolution_clock::now();
+
+	InfluenceGrid& grid = *m_grid;
+	const float* source = grid.m_values[grid.m_currentBuffer].data();
+	float* destination = grid.m_values[1 - grid.m_currentBuffer].data();
+	const float* walkable = grid.m_walkable.data();
+	const float* numNeighbors = grid.m_numWalkableNeighbors.data();
+	int stride = grid.m_stride;
+	float rate = grid.m_diffusionRate;
+
+	// Each tile hands rate * value to every walkable neighbor and takes the same share of theirs, so the total is kept.
+	// Blocked cells always hold zero, which lets the neighbor sum skip any walkability test
+	for (int paddedY = 1; paddedY <= grid.m_dimensions.y; paddedY++)
+	{
+		int rowStart = paddedY * stride + 1;
+		int rowEnd = rowStart + grid.m_dimensions.x;
+		int index = rowStart;
+
+#ifdef INFLUENCE_USE_SSE
+		__m128 rateLanes = _mm_set1_ps(rate);
+		for (; index + 4 <= rowEnd; index += 4)
+		{
+			__m128 center = _mm_loadu_ps(source + index);
+			__m128 neighborSum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(source + index - 1), _mm_loadu_ps(source + index + 1)), _mm_add_ps(_mm_loadu_ps(source + index - stride), _mm_loadu_ps(source + index + stride)));
+			__m128 flow = _mm_sub_ps(neighborSum, _mm_mul_ps(_mm_loadu_ps(numNeighbors + index), center));
+			__m128 result = _mm_add_ps(center, _mm_mul_ps(rateLanes, flow));
+			_mm_storeu_ps(destination + index, _mm_mul_ps(result, _mm_loadu_ps(walkable + index)));
+		}
+#endif
+		for (; index < rowEnd; index++)
+		{
+			float center = source[index];
+			float neighborSum = source[index - 1] + source[index + 1] + source[index - stride] + source[index + stride];
+			destination[index] = (center + rate * (neighborSum - numNeighbors[index] * center)) * walkable[index];
+		}
+	}
+
+	auto executeEnd = std::chrono::high_resolution_clock::now();
+	m_lastExecuteMS = std::chrono::duration<float, std::milli>(executeEnd - executeStart).count();
+	m_state = JobStatus::COMPLETED;
+}
+
+InfluenceMap::~InfluenceMap()
+{
+	// A job still running keeps the grid alive through its shared_ptr, Map::RetrieveCompletedPathfindingJobs deletes it later
+	if (!m_isJobInFlight)
+	{
+		delete m_diffusionJob;
+	}
+	m_diffusionJob = nullptr;
+}
+
+void InfluenceMap::Initialize(unsigned int mapID, const IntVec2& dimensions, const std::vector<unsigned char>& solidTiles, float diffusionRate)
+{
+	m_grid = std::make_shared<InfluenceGrid>();
+	m_grid->m_dimensions = dimensions;
+	m_grid->m_stride = dimensions.x + 2;
+	// Above a quarter a tile could hand out more than it holds
+	m_grid->m_diffusionRate = std::min(diffusionRate, 0.25f);
+
+	size_t numPaddedTiles = static_cast<size_t>(dimensions.x + 2) * static_cast<size_t>(dimensions.y + 2);
+	m_grid->m_values[0].assign(numPaddedTiles, 0.f);
+	m_grid->m_values[1].assign(numPaddedTiles, 0.f);
+	m_grid->m_walkable.assign(numPaddedTiles, 0.f);
+	m_grid->m_numWalkableNeighbors.assign(numPaddedTiles, 0.f);
+
+	for (int tileY = 0; tileY < dimensions.y; tileY++)
+	{
+		for (int tileX = 0; tileX < dimensions.x; tileX++)
+		{
+			m_grid->m_walkable[GetPaddedIndex(tileX, tileY)] = solidTiles[tileX + tileY * dimensions.x] ? 0.f : 1.f;
+		}
+	}
+	for (int tileY = 0; tileY < dimensions.y; tileY++)
+	{
+		for (int tileX = 0; tileX < dimensions.x; tileX++)
+		{
+			RecountWalkableNeighbors(GetPaddedIndex(tileX, tileY));
+		}
+	}
+
+	delete m_diffusionJob;
+	m_diffusionJob = new InfluenceDiffusionJob(mapID, m_grid);
+	m_isJobInFlight = false;
+}
+
+void InfluenceMap::Update(Map* map)
+{
+	// The buffers are only touched here while no diffusion is running
+	if (m_isJobInFlight || m_grid == nullptr)
+	{
+		return;
+	}
+
+	ApplyPendingTileEdits(map);
+
+	const SquadBlackboard& squadBlackboard = map->m_squadBlackboard;
+	if (!squadBlackboard.HasSeenPlayer())
+	{
+		return;
+	}
+
+	if (squadBlackboard.GetNumSeeingPlayer() > 0)
+	{
+		CollapseToTile(map->GetTileCoordsForPos(squadBlackboard.GetLastSeenPosition()));
+	}
+	else
+	{
+		for (Actor* actor : map->m_actors)
+		{
+			if (actor == nullptr || !actor->m_isAI || actor->GetAiController() == nullptr)
+			{
+				continue;
+			}
+
+			AIActor* aiController = actor->GetAiController();
+			Vec3 forward = actor->m_orientation.GetForwardVector();
+			Vec2 forwardXY = Vec2(forward.x, forward.y).GetNormalized();
+			float cosSightFOV = aiController->m_sightFOV >= 180.f ? -1.f : CosDegrees(aiController->m_sightFOV);
+			ClearViewedTiles(map->m_tileVisibility, Vec2(actor->m_position.x, actor->m_position.y), forwardXY, aiController->m_sightDistance, cosSightFOV, aiController->m_sensorRadius);
+		}
+	}
+
+	m_diffusionJob->m_state = JobStatus::NEW;
+	m_isJobInFlight = true;
+	g_theJobSystem->QueueJob(m_diffusionJob);
+}
+
+void InfluenceMap::OnDiffusionJobCompleted()
+{
+	m_grid->m_currentBuffer = 1 - m_grid->m_currentBuffer;
+	m_isJobInFlight = false;
+	// Only read once the job has been handed back, the worker writes it while the job runs
+	m_lastDiffusionMS = m_diffusionJob->m_lastExecuteMS;
+}
+
+void InfluenceMap::OnTileSolidityChanged(const IntVec2& tileCoords)
+{
+	m_pendingTileEdits.push_back(tileCoords);
+}
+
+bool InfluenceMap::SampleSearchGoal(const IntVec2& centerTile, int radius, RandomNumberGenerator& rng, IntVec2& outGoalTile) const
+{
+	if (m_grid == nullptr)
+	{
+		return false;
+	}
+
+	int minX = std::max(centerTile.x - radius, 0);
+	int minY = std::max(centerTile.y - radius, 0);
+	int maxX = std::min(centerTile.x + radius, m_grid->m_dimensions.x - 1);
+	int maxY = std::min(centerTile.y + radius, m_grid->m_dimensions.y - 1);
+
+	// The job only writes the other buffer, so reading the current one while it runs is safe
+	const std::vector<float>& values = m_grid->m_values[m_grid->m_currentBuffer];
+	float totalWeight = 0.f;
+	for (int tileY = minY; tileY <= maxY; tileY++)
+	{
+		for (int tileX = minX; tileX <= maxX; tileX++)
+		{
+			totalWeight += values[GetPaddedIndex(tileX, tileY)];
+		}
+	}
+
+	if (totalWeight <= 0.f)
+	{
+		return false;
+	}
+
+	float remainingWeight = rng.RollRandomFloatInRange(0.f, totalWeight);
+	for (int tileY = minY; tileY <= maxY; tileY++)
+	{
+		for (int tileX = minX; tileX <= maxX; tileX++)
+		{
+			float weight = values[GetPaddedIndex(tileX, tileY)];
+			if (weight <= 0.f)
+			{
+				continue;
+			}
+
+			outGoalTile = IntVec2(tileX, tileY);
+			remainingWeight -= weight;
+			if (remainingWeight <= 0.f)
+			{
+				return true;
+			}
+		}
+	}
+
+	// Rounding can leave a sliver of weight over, the last tile with any weight takes it
+	return true;
+}
+
+float InfluenceMap::GetValue(const IntVec2& tileCoords) const
+{
+	if (m_grid == nullptr || tileCoords.x < 0 || tileCoords.y < 0 || tileCoords.x >= m_grid->m_dimensions.x || tileCoords.y >= m_grid->m_dimensions.y)
+	{
+		return 0.f;
+	}
+	return m_grid->m_values[m_grid->m_currentBuffer][GetPaddedIndex(tileCoords.x, tileCoords.y)];
+}
+
+float InfluenceMap::GetLastDiffusionMS() const
+{
+	return m_lastDiffusionMS;
+}
+
+void InfluenceMap::CollapseToTile(const IntVec2& tileCoords)
+{
+	std::vector<float>& values = m_grid->m_values[m_grid->m_currentBuffer];
+	std::fill(values.begin(), values.end(), 0.f);
+	if (tileCoords.x >= 0 && tileCoords.y >= 0 && tileCoords.x < m_grid->m_dimensions.x && tileCoords.y < m_grid->m_dimensions.y)
+	{
+		int paddedIndex = GetPaddedIndex(tileCoords.x, tileCoords.y);
+		values[paddedIndex] = m_grid->m_walkable[paddedIndex];
+	}
+}
+
+void InfluenceMap::ClearViewedTiles(const TileVisibilitySet& tileVisibility, const Vec2& eyePos, const Vec2& forward, float sightDistance, float cosSightFOV, float sensorRadius)
+{
+	std::vector<float>& values = m_grid->m_values[m_grid->m_currentBuffer];
+	IntVec2 eyeTile = IntVec2(RoundDownToInt(eyePos.x), RoundDownToInt(eyePos.y));
+	float viewRange = std::max(sightDistance, sensorRadius);
+	int tileRange = static_cast<int>(ceilf(viewRange));
+
+	int minX = std::max(eyeTile.x - tileRange, 0);
+	int minY = std::max(eyeTile.y - tileRange, 0);
+	int maxX = std::min(eyeTile.x + tileRange, m_grid->m_dimensions.x - 1);
+	int maxY = std::min(eyeTile.y + tileRange, m_grid->m_dimensions.y - 1);
+
+	for (int tileY = minY; tileY <= maxY; tileY++)
+	{
+		for (int tileX = minX; tileX <= maxX; tileX++)
+		{
+			int paddedIndex = GetPaddedIndex(tileX, tileY);
+			if (values[paddedIndex] == 0.f)
+			{
+				continue;
+			}
+
+			Vec2 toTileCenter = Vec2((float)tileX + 0.5f - eyePos.x, (float)tileY + 0.5f - eyePos.y);
+			float distanceSq = toTileCenter.x * toTileCenter.x + toTileCenter.y * toTileCenter.y;
+			bool isInSensorRadius = distanceSq <= sensorRadius * sensorRadius;
+			bool isInSightCone = distanceSq <= sightDistance * sightDistance && (toTileCenter.x * forward.x + toTileCenter.y * forward.y) >= cosSightFOV * sqrtf(distanceSq);
+			if ((isInSensorRadius || isInSightCone) && tileVisibility.IsPotentiallyVisible(eyeTile, IntVec2(tileX, tileY)))
+			{
+				values[paddedIndex] = 0.f;
+			}
+		}
+	}
+}
+
+void InfluenceMap::ApplyPendingTileEdits(const Map* map)
+{
+	for (const IntVec2& tileCoords : m_pendingTileEdits)
+	{
+		int paddedIndex = GetPaddedIndex(tileCoords.x, tileCoords.y);
+		bool isSolid = map->IsSolidTile(tileCoords.x, tileCoords.y);
+		m_grid->m_walkable[paddedIndex] = isSolid ? 0.f : 1.f;
+		if (isSolid)
+		{
+			m_grid->m_values[m_grid->m_currentBuffer][paddedIndex] = 0.f;
+		}
+
+		RecountWalkableNeighbors(paddedIndex);
+		RecountWalkableNeighbors(paddedIndex - 1);
+		RecountWalkableNeighbors(paddedIndex + 1);
+		RecountWalkableNeighbors(paddedIndex - m_grid->m_stride);
+		RecountWalkableNeighbors(paddedIndex + m_grid->m_stride);
+	}
+	m_pendingTileEdits.clear();
+}
+
+void InfluenceMap::RecountWalkableNeighbors(int paddedIndex)
+{
+	// Border cells are never walkable, their counts are never read
+	const std::vector<float>& walkable = m_grid->m_walkable;
+	int stride = m_grid->m_stride;
+	int paddedX = paddedIndex % stride;
+	int paddedY = paddedIndex / stride;
+	if (paddedX < 1 || paddedY < 1 || paddedX > m_grid->m_dimensions.x || paddedY > m_grid->m_dimensions.y)
+	{
+		return;
+	}
+	m_grid->m_numWalkableNeighbors[paddedIndex] = walkable[paddedIndex - 1] + walkable[paddedIndex + 1] + walkable[paddedIndex - stride] + walkable[paddedIndex + stride];
+}
+
+int InfluenceMap::GetPaddedIndex(int tileX, int tileY) const
+{
+	return (tileX + 1) + (tileY + 1) * m_grid->m_stride;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include <vector>
+#include <memory>
+
+class Map;
+class TileVisibilitySet;
+class RandomNumberGenerator;
+
+// Both value buffers and the walkability data live here, shared between the map and the diffusion job.
+// The grid has a one tile border of blocked cells so the kernel never has to check bounds.
+struct InfluenceGrid
+{
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	int m_stride = 0;
+	int m_currentBuffer = 0;
+	float m_diffusionRate = 0.2f;
+	std::vector<float> m_values[2];
+	std::vector<float> m_walkable;
+	std::vector<float> m_numWalkableNeighbors;
+};
+
+// Spreads every walkable tile's value to its walkable neighbors, reading the current buffer and
+// writing the other. One job is created with the influence map and queued again every tick.
+class InfluenceDiffusionJob : public Job
+{
+public:
+	InfluenceDiffusionJob(unsigned int mapID, std::shared_ptr<InfluenceGrid> grid);
+
+	virtual void Execute() override;
+
+public:
+	unsigned int m_mapID = 0;
+	std::shared_ptr<InfluenceGrid> m_grid;
+	float m_lastExecuteMS = 0.f;
+};
+
+// Map-wide estimate of where the player might be. While any AI sees the player all of the weight sits
+// on the last seen tile. Once they lose sight of the player it spreads along walkable tiles a little every
+// tick, and tiles an AI is looking at are emptied. AIs in the search state sample it to pick their next goal.
+class InfluenceMap
+{
+public:
+	InfluenceMap() = default;
+	~InfluenceMap();
+
+	void Initialize(unsigned int mapID, const IntVec2& dimensions, const std::vector<unsigned char>& solidTiles, float diffusionRate);
+	void Update(Map* map);
+	void OnDiffusionJobCompleted();
+	void OnTileSolidityChanged(const IntVec2& tileCoords);
+
+	bool SampleSearchGoal(const IntVec2& centerTile, int radius, RandomNumberGenerator& rng, IntVec2& outGoalTile) const;
+	float GetValue(const IntVec2& tileCoords) const;
+	float GetLastDiffusionMS() const;
+
+private:
+	void CollapseToTile(const IntVec2& tileCoords);
+	void ClearViewedTiles(const TileVisibilitySet& tileVisibility, const Vec2& eyePos, const Vec2& forward, float sightDistance, float cosSightFOV, float sensorRadius);
+	void ApplyPendingTileEdits(const Map* map);
+	void RecountWalkableNeighbors(int paddedIndex);
+	int GetPaddedIndex(int tileX, int tileY) const;
+
+private:
+	std::shared_ptr<InfluenceGrid> m_grid;
+	InfluenceDiffusionJob* m_diffusionJob = nullptr;
+	bool m_isJobInFlight = false;
+	float m_lastDiffusionMS = 0.f;
+	std::vector<IntVec2> m_pendingTileEdits;
+};
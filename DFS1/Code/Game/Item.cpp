@@ -2,32 +2,37 @@
 #include "Game/Map.hpp"
 #include "Game/App.hpp"
 #include "Game/Game.hpp"
-#include "Game/ActorType.hpp"
 #include "Engine/Core/Clock.hpp"
-#include "Engine/Renderer/DebugRenderer.hpp"
+#include "Engine/Math/EulerAngles.hpp"
 #include <cmath>
 
+constexpr float ITEM_ROTATION_SPEED = 50.f;
+constexpr float ITEM_BOB_AMPLITUDE = 0.25f;
+constexpr float ITEM_BOB_FREQUENCY = 2.f; // Oscillations per second
+constexpr float ITEM_BASE_HEIGHT = 1.1f;
+
 Item::Item(ActorUID uid, Map* map)
 	: m_actorUID(uid), m_map(map)
 {
 }
 
-void Item::Update()
+Mat44 Item::GetAnimatedModelMatrix(const Vec3& restPosition) const
 {
-	m_actor = m_map->GetActorByUID(m_actorUID);
+	float time = g_theApp->m_game->m_clock->GetTotalSeconds();
 
-	float rotationSpeed = 50.f;
-	float rotation = rotationSpeed * g_theApp->m_game->m_clock->GetDeltaSeconds();
+	// Tumbles on all three axes at once
+	float rotation = ITEM_ROTATION_SPEED * time;
+	EulerAngles orientation(rotation, rotation, rotation);
 
-	m_actor->m_orientation.m_yawDegrees += rotation;
-	m_actor->m_orientation.m_rollDegrees += rotation;
-	m_actor->m_orientation.m_pitchDegrees += rotation;
+	// Up-and-down oscillation using sine function
+	Vec3 position = Vec3(restPosition.x, restPosition.y, ITEM_BASE_HEIGHT + ITEM_BOB_AMPLITUDE * std::sin(ITEM_BOB_FREQUENCY * time));
 
- 	// Up-and-down oscillation using sine function
-	float amplitude = 0.25f; // Amplitude of the oscillation
-	float frequency = 2.f; // Frequency of the oscillation (oscillations per second)
-	float baseHeight = 1.1f; // Base height for the oscillation
-	float time = g_theApp->m_game->m_clock->GetTotalSeconds();
+	Mat44 modelMatrix = Mat44::CreateTranslation3D(position);
+	modelMatrix.Append(orientation.GetAsMatrix_IFwd_JLeft_KUp());
+	return modelMatrix;
+}
 
-	m_actor->m_position.z = baseHeight + amplitude * std::sin(frequency * time);
+FloatRange Item::GetTriggerHeightRange(float boxHeight) const
+{
+	return FloatRange(ITEM_BASE_HEIGHT - ITEM_BOB_AMPLITUDE, ITEM_BASE_HEIGHT + ITEM_BOB_AMPLITUDE + boxHeight);
 }
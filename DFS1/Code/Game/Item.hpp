@@ -1,18 +1,24 @@
 #pragma once
-#include "Game/Actor.hpp"
+#include "Game/ActorUID.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/FloatRange.hpp"
 
 class Map;
 
-class Item : public Actor
+// The pickup side of an item actor. Items never move or think, the spin and bob are worked out from the clock
+// when the item is drawn, and picking one up is the map's trigger table noticing the player over it.
+class Item
 {
 public:
 	Item(ActorUID uid, Map* map);
 	~Item() = default;
 
-	void Update();
+	Mat44 GetAnimatedModelMatrix(const Vec3& restPosition) const;
+	FloatRange GetTriggerHeightRange(float boxHeight) const; // Everywhere the box reaches while bobbing
 
 public:
 	ActorUID m_actorUID = ActorUID::INVALID;
-	Actor* m_actor = nullptr;	
 	Map* m_map = nullptr;
-};
\ No newline at end of file
+	int m_triggerIndex = -1;
+};
@@ -1,4 +1,5 @@
 #include "Game/Game.hpp"
+#include "Game/App.hpp"
 #include "Game/Map.hpp"
 #include "Game/Player.hpp"
 #include "Engine/Core/Image.hpp"
@@ -17,15 +18,29 @@
 #include "Engine/Renderer/DebugRenderer.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Game/Actor.hpp"
+#include "Game/AIActor.hpp"
+#include "Game/Item.hpp"
+#include "Game/ActorUpdateJob.hpp"
+#include "Game/SimulationThread.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Game/Controller.hpp"
 #include "Game/ActorDefinitions.hpp"
 #include "Game/GameCommon.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Core/DevConsole.hpp"
 #include <unordered_set>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 
 struct TileDefinition;
 
+extern DevConsole* g_theConsole;
+
+unsigned int Map::s_nextMapID = 1;
+
 Map::~Map()
 {
 	MapShutDown();
@@ -38,8 +53,32 @@ Map::Map(Game* owner, MapDefinition definition)
 	m_sunIntensity = 0.5f;
 	m_ambientIntensity = 0.5f;
 	m_dimensions = m_definition.m_mapImage->GetDimensions();
+	m_mapID = s_nextMapID++;
+	m_pathCache = std::make_shared<PathCache>();
+	m_isBatchingPathRequests = g_defaultConfigBlackboard->GetValue("batchPathfinding", true);
+	m_isSmoothingPaths = g_defaultConfigBlackboard->GetValue("smoothPaths", true);
+	m_isBatchingPerception = g_defaultConfigBlackboard->GetValue("batchPerception", true);
+	m_isUsingPatrolNetwork = g_defaultConfigBlackboard->GetValue("patrolNetwork", true);
+	m_isUpdatingActorsInParallel = g_defaultConfigBlackboard->GetValue("parallelActorUpdate", true);
+	m_minActorsPerUpdateJob = static_cast<int>(g_defaultConfigBlackboard->GetValue("actorsPerUpdateJob", 64.f));
+	m_isUsingFixedStep = g_defaultConfigBlackboard->GetValue("fixedTimestep", true);
+	m_fixedStepSeconds = 1.f / std::max(1.f, g_defaultConfigBlackboard->GetValue("simulationRate", 60.f));
+	m_maxStepsPerFrame = std::max(1, static_cast<int>(g_defaultConfigBlackboard->GetValue("maxStepsPerFrame", 5.f)));
+	m_isUsingSimulationThread = g_defaultConfigBlackboard->GetValue("simulationThread", true);
+	m_isSweepingWallCollision = g_defaultConfigBlackboard->GetValue("sweptWallCollision", true);
+	m_actorCollisionIterations = std::max(1, static_cast<int>(g_defaultConfigBlackboard->GetValue("actorCollisionIterations", 1.f)));
+	m_actorGrid.Initialize(m_dimensions, static_cast<int>(g_defaultConfigBlackboard->GetValue("actorGridCellSize", 1.f)));
+	m_triggers.Initialize(m_dimensions);
+	m_timers.Initialize(this, m_fixedStepSeconds);
+	m_aiLevelOfDetail.Initialize(g_defaultConfigBlackboard->GetValue("aiLevelOfDetail", true), g_defaultConfigBlackboard->GetValue("aiNearRadius", 16.f), g_defaultConfigBlackboard->GetValue("aiMidRadius", 40.f), static_cast<int>(g_defaultConfigBlackboard->GetValue("aiMidThinkInterval", 4.f)));
 	
 	InitializeMap();
+	PublishNavSnapshot();
+	BuildTileVisibility();
+	m_wallDistance.Build(m_dimensions, m_navSnapshot->GetSolidTiles());
+	m_alertWavefront.Initialize(m_dimensions, static_cast<int>(g_defaultConfigBlackboard->GetValue("alertRadius", 12.f)), g_defaultConfigBlackboard->GetValue("alertSpeed", 24.f));
+	m_influenceMap.Initialize(m_mapID, m_dimensions, m_navSnapshot->GetSolidTiles(), g_defaultConfigBlackboard->GetValue("influenceDiffusionRate", 0.2f));
+	BuildPatrolNetwork();
 	CreateSky();
 
 	Texture* terrain_8x8 = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/Terrain_8x8.png");
@@ -57,6 +96,14 @@ Map::Map(Game* owner, MapDefinition definition)
 	PopulateMapWithEnemyActors("EnemyStartPoint");
 	PopulateMapWithTimerBoxActors("ItemSpawnPoint");
 	GetMaxNumberSpawnedEnemyActors();
+
+	// Rendering always reads a snapshot, give it one before the first frame is simulated
+	PublishRenderSnapshot();
+	m_renderSnapshots.AcquireLatest();
+	if (m_isUsingSimulationThread)
+	{
+		m_simulationThread = new SimulationThread(this);
+	}
 }
 
 void Map::InitializeMap()
@@ -80,6 +127,44 @@ void Map::InitializeMap()
 	}
 }
 
+void Map::PublishNavSnapshot()
+{
+	std::vector<unsigned char> solidTiles(m_tiles.size());
+	for (int tileIndex = 0; tileIndex < m_tiles.size(); tileIndex++)
+	{
+		solidTiles[tileIndex] = m_tiles[tileIndex].GetTileDefinition()->m_isSolid ? 1 : 0;
+	}
+
+	// Jobs still holding the previous snapshot keep it alive until they finish
+	bool useRectGraph = m_definition.m_navigationMode == NavigationMode::RECT;
+	m_navSnapshot = std::make_shared<const NavSnapshot>(m_mapID, m_navVersion, m_dimensions, std::move(solidTiles), useRectGraph);
+}
+
+void Map::BuildTileVisibility()
+{
+	int radius = static_cast<int>(ceilf(g_defaultConfigBlackboard->GetValue("pvsRadius", 10.f)));
+
+	auto buildStart = std::chrono::high_resolution_clock::now();
+	m_tileVisibility.Build(m_dimensions, m_navSnapshot->GetSolidTiles(), radius);
+	auto buildEnd = std::chrono::high_resolution_clock::now();
+	m_lastVisibilityBuildMS = std::chrono::duration<float, std::milli>(buildEnd - buildStart).count();
+
+	g_theConsole->AddLine(Rgba8::LIGHT_BLUE, Stringf("Tile visibility built for %dx%d tiles (radius %d) in %.2f ms, %.1f KB", m_dimensions.x, m_dimensions.y, radius, m_lastVisibilityBuildMS, static_cast<float>(m_tileVisibility.GetMemoryBytes()) / 1024.f));
+}
+
+void Map::BuildPatrolNetwork()
+{
+	if (!m_isUsingPatrolNetwork)
+	{
+		return;
+	}
+
+	int waypointSpacing = static_cast<int>(g_defaultConfigBlackboard->GetValue("patrolWaypointSpacing", 8.f));
+	m_patrolNetwork.Build(*m_navSnapshot, waypointSpacing, g_defaultConfigBlackboard->GetValue("patrolRandomBranches", true));
+
+	g_theConsole->AddLine(Rgba8::LIGHT_BLUE, Stringf("Patrol network built with %d waypoints and %d routes in %.2f ms", m_patrolNetwork.GetNumWaypoints(), m_patrolNetwork.GetNumEdges(), m_patrolNetwork.GetLastBuildMS()));
+}
+
 void Map::AddVertsForTile(int tileIndex, const SpriteSheet& spriteSheet)
 {
 	AABB3 tileBounds = m_tiles[tileIndex].GetTileBounds();
@@ -371,10 +456,10 @@ IntVec2 Map::GetTileCoordsForPos(const Vec3& position)
 	return IntVec2(RoundDownToInt(position.x), RoundDownToInt(position.y));
 }
 
-IntVec2 Map::GetRandomTilewithinRange(const IntVec2& startPos, int range) const
+IntVec2 Map::GetRandomTilewithinRange(const IntVec2& startPos, int range, RandomNumberGenerator& rng) const
 {
 	IntVec2 randomTile;
-	IntVec2 randomIntVec2 = g_rng.SRollRandomIntVec2InRange(-range, range);
+	IntVec2 randomIntVec2 = rng.SRollRandomIntVec2InRange(-range, range);
 	randomTile = startPos + randomIntVec2;
 
 	return randomTile;
@@ -391,6 +476,32 @@ bool Map::IsSolidTile(int tileX, int tileY) const
 	return tile->GetTileDefinition()->m_isSolid;
 }
 
+void Map::SetTileDefinition(const IntVec2& tileCoords, const TileDefinition* tileDef)
+{
+	if (!AreCoordsInBounds(tileCoords.x, tileCoords.y) || tileDef == nullptr)
+	{
+		return;
+	}
+
+	Tile& tile = m_tiles[GetTileIndex(tileCoords.x, tileCoords.y)];
+	bool wasSolid = tile.GetTileDefinition()->m_isSolid;
+	tile.SetTileType(tileDef);
+
+	if (wasSolid != tileDef->m_isSolid)
+	{
+		// Diagonal moves check both neighbors, so paths cutting past the tile's corners are affected as well
+		m_navVersion++;
+		PublishNavSnapshot();
+		m_pathCache->InvalidateRegion(tileCoords - IntVec2(1, 1), tileCoords + IntVec2(1, 1), m_navVersion);
+		m_tileVisibility.RebuildAroundTile(m_navSnapshot->GetSolidTiles(), tileCoords);
+		m_wallDistance.UpdateAroundTile(m_navSnapshot->GetSolidTiles(), tileCoords);
+		m_influenceMap.OnTileSolidityChanged(tileCoords);
+		BuildPatrolNetwork(); // Waypoint indices shift, patrolling AIs notice they are off the network and rejoin
+	}
+
+	RebuildTileBuffers();
+}
+
 bool Map::AreAdjacentTileNonSolid(const IntVec2& currentTilePos, const IntVec2& neighborCoords) const
 {
 	IntVec2 direction = neighborCoords - currentTilePos;
@@ -466,15 +577,7 @@ void Map::PopulateMapWithEnemyActors(const std::string& tileTypeName)
 			Tile* chosenTile = m_matchingEnemyTiles[spawnIndex];
 
 			// Check if any actor is already at the chosen tile position
-			bool positionOccupied = false;
-			for (int actor = 0; actor < m_actors.size(); actor++) 
-			{
-				if (m_actors[actor] != nullptr && m_actors[actor]->GetActorPosition() == chosenTile->GetTilePosition()) 
-				{
-					positionOccupied = true;
-					break;
-				}
-			}
+			bool positionOccupied = IsActorAtPosition(chosenTile->GetTilePosition());
 
 			if (!positionOccupied) 
 			{
@@ -538,15 +641,7 @@ void Map::PopulateMapWithTimerBoxActors(const std::string& tileTypeName)
 			Tile* chosenTile = m_matchingTimerBoxTiles[spawnIndex];
 
 			// Check if any actor is already at the chosen tile position
-			bool positionOccupied = false;
-			for (int actor = 0; actor < m_actors.size(); actor++)
-			{
-				if (m_actors[actor] != nullptr && m_actors[actor]->GetActorPosition() == chosenTile->GetTilePosition())
-				{
-					positionOccupied = true;
-					break;
-				}
-			}
+			bool positionOccupied = IsActorAtPosition(chosenTile->GetTilePosition());
 
 			if (!positionOccupied)
 			{
@@ -639,6 +734,17 @@ void Map::CreateSky()
 }
 
 void Map::CreateBuffers()
+{
+	CreateTileBuffers();
+
+	m_skyVertexBuffer = g_theRenderer->CreateVertexBuffer(m_skyVertices.size());
+	g_theRenderer->CopyCPUToGPU(m_skyVertices.data(), m_skyVertices.size() * sizeof(Vertex_PCU), m_skyVertexBuffer);
+
+	m_skyIndexBuffer = g_theRenderer->CreateIndexBuffer(m_skyIndexes.size());
+	g_theRenderer->CopyCPUToGPU(m_skyIndexes.data(), m_skyIndexes.size() * sizeof(unsigned int), m_skyIndexBuffer);
+}
+
+void Map::CreateTileBuffers()
 {
 	size_t vertexBufferSize = sizeof(Vertex_PCUTBN) * m_tileVertexes.size();
 	m_tileVertexBuffer = g_theRenderer->CreateVertexBuffer(vertexBufferSize);
@@ -647,37 +753,264 @@ void Map::CreateBuffers()
 	size_t indexBufferSize = sizeof(unsigned int) * m_tileIndexes.size();
 	m_tileIndexBuffer = g_theRenderer->CreateIndexBuffer(indexBufferSize);
 	g_theRenderer->CopyCPUToGPU(m_tileIndexes.data(), indexBufferSize, m_tileIndexBuffer);
+}
 
-	m_skyVertexBuffer = g_theRenderer->CreateVertexBuffer(m_skyVertices.size());
-	g_theRenderer->CopyCPUToGPU(m_skyVertices.data(), m_skyVertices.size() * sizeof(Vertex_PCU), m_skyVertexBuffer);
+void Map::RebuildTileBuffers()
+{
+	m_tileVertexes.clear();
+	m_tileIndexes.clear();
 
-	m_skyIndexBuffer = g_theRenderer->CreateIndexBuffer(m_skyIndexes.size());
-	g_theRenderer->CopyCPUToGPU(m_skyIndexes.data(), m_skyIndexes.size() * sizeof(unsigned int), m_skyIndexBuffer);
+	for (int tileIndex = 0; tileIndex < m_tiles.size(); tileIndex++)
+	{
+		AddVertsForTile(tileIndex, *m_terrainSpriteSheet);
+	}
+
+	SafeDelete(m_tileVertexBuffer);
+	SafeDelete(m_tileIndexBuffer);
+	CreateTileBuffers();
 }
 
 void Map::RenderActors()
 {
-	for (int index = 0; index < m_actors.size(); index++)
+	for (const ActorRenderState& actorState : GetRenderSnapshot().m_actors)
 	{
-		if (m_actors[index] == nullptr)
+		actorState.m_actor->Render(actorState);
+	}
+}
+
+void Map::MapUpdate()
+{
+	// Nothing is simulating at this point, the last frame's steps were waited for at the end of rendering
+	DeleteRetiredActors();
+
+	// Input and the camera follow the render frame, the world itself only moves in whole steps
+	m_game->m_player->Update();
+	DebugKeys();
+
+	float frameDeltaSeconds = m_game->m_clock->GetDeltaSeconds();
+	if (m_simulationThread)
+	{
+		// This frame renders what the last frame simulated while the simulation thread works on the next one
+		AcquireRenderSnapshot();
+		m_simulationThread->StartFrame(frameDeltaSeconds);
+		return;
+	}
+
+	RunSimulationFrame(frameDeltaSeconds);
+	AcquireRenderSnapshot();
+}
+
+void Map::RunSimulationFrame(float frameDeltaSeconds)
+{
+	std::chrono::high_resolution_clock::time_point frameStart = std::chrono::high_resolution_clock::now();
+
+	if (!m_isUsingFixedStep)
+	{
+		m_stepDeltaSeconds = frameDeltaSeconds;
+		m_numStepsLastFrame = 1;
+		m_stepInterpolation = 1.f;
+		SavePreviousTransforms();
+		UpdateSimulationStep();
+	}
+	else
+	{
+		// Steps are a fixed size whatever the frame rate, the leftover time carries into the next frame.
+		// Past the step cap the backlog is dropped, after a stall the world slows down rather than trying to catch up
+		m_stepDeltaSeconds = m_fixedStepSeconds;
+		m_stepAccumulatorSeconds += frameDeltaSeconds;
+		m_numStepsLastFrame = 0;
+		while (m_stepAccumulatorSeconds >= m_fixedStepSeconds && m_numStepsLastFrame < m_maxStepsPerFrame)
 		{
-			continue;
+			SavePreviousTransforms();
+			UpdateSimulationStep();
+			m_stepAccumulatorSeconds -= m_fixedStepSeconds;
+			m_numStepsLastFrame++;
+		}
+		if (m_stepAccumulatorSeconds >= m_fixedStepSeconds)
+		{
+			m_stepAccumulatorSeconds = fmodf(m_stepAccumulatorSeconds, m_fixedStepSeconds);
 		}
-		m_actors[index]->Render();
+
+		// Rendering blends from the state before the last step towards the latest one by the time already banked
+		m_stepInterpolation = m_stepAccumulatorSeconds / m_fixedStepSeconds;
 	}
+
+	std::chrono::duration<float, std::milli> frameTime = std::chrono::high_resolution_clock::now() - frameStart;
+	m_lastSimulationFrameMS = frameTime.count();
+	PublishRenderSnapshot();
 }
 
-void Map::MapUpdate()
+void Map::WaitForSimulation()
+{
+	if (m_simulationThread == nullptr)
+	{
+		return;
+	}
+
+	std::chrono::high_resolution_clock::time_point waitStart = std::chrono::high_resolution_clock::now();
+	m_simulationThread->WaitForFrame();
+	std::chrono::duration<float, std::milli> waitTime = std::chrono::high_resolution_clock::now() - waitStart;
+	m_lastSimulationWaitMS = waitTime.count();
+}
+
+void Map::UpdateSimulationStep()
 {
+	m_visibilityCache.Clear();
+	m_timers.Advance(m_stepDeltaSeconds);
+	RetrieveCompletedPathfindingJobs();
 	UpdateGameLogic();
+	UpdatePerception();
+	UpdateSquadAlerts();
+	UpdateInfluenceMap();
+	UpdateAILevelOfDetail();
 	UpdateActors();
+	UpdateActorPhysics();
+	QueueBatchedPathfindingJobs();
 	CollideActors();
 	CollideActorsWithMap();
-	DebugKeys();
+	UpdateTriggers();
 	//AdjustLightCommands();
 	DeleteDestroyedActors();
 }
 
+void Map::SavePreviousTransforms()
+{
+	// The wall sweep also traces each actor's move in the coming step from these positions
+	for (Actor* actor : m_actors)
+	{
+		actor->m_previousPosition = actor->m_position;
+		actor->m_previousOrientation = actor->m_orientation;
+	}
+}
+
+float Map::GetStepDeltaSeconds() const
+{
+	return m_stepDeltaSeconds;
+}
+
+void Map::PublishRenderSnapshot()
+{
+	RenderSnapshot& snapshot = m_renderSnapshots.GetWriteBuffer();
+	for (Actor* actor : m_actors)
+	{
+		if (actor->m_isVisible)
+		{
+			snapshot.m_actors.push_back(actor->GetRenderState());
+		}
+	}
+
+	Actor* playerActor = GetPlayerActor();
+	snapshot.m_hasPlayerActor = playerActor != nullptr;
+	if (playerActor)
+	{
+		snapshot.m_playerPosition = playerActor->GetRenderPosition();
+		snapshot.m_playerOrientation = playerActor->GetRenderOrientation();
+		snapshot.m_playerEyeHeight = playerActor->m_eyeHeight;
+		snapshot.m_playerHealth = playerActor->m_health;
+	}
+	snapshot.m_gameTime = m_gameTime;
+	snapshot.m_didAddTime = m_didAddTime;
+	snapshot.m_hasPlayerReachedGoal = m_hasPlayerReachedGoal;
+	snapshot.m_numEnemies = static_cast<int>(m_numEnemyActors.size());
+
+	Player* player = m_game->m_player;
+	if (player->m_isShowingDebugOptions && player->m_currentCameraMode == CameraMode::MAP)
+	{
+		AddDebugOverlayLines(snapshot);
+	}
+
+	m_renderSnapshots.Publish();
+
+	// The buffer handed back was last read two frames ago, debug draws for the next frame go into it from scratch
+	m_renderSnapshots.GetWriteBuffer().Clear();
+}
+
+void Map::AcquireRenderSnapshot()
+{
+	// Debug draws are only handed over once, some of them outlive the frame they were added in
+	if (m_renderSnapshots.AcquireLatest())
+	{
+		GetRenderSnapshot().SubmitDebugPrimitives();
+	}
+	m_game->m_player->UpdateCamera(GetRenderSnapshot());
+}
+
+void Map::AddDebugOverlayLines(RenderSnapshot& snapshot)
+{
+	// Built on the simulating thread along with the rest of the snapshot, the render side just prints them
+	PathCacheStats pathCacheStats = m_pathCache->GetStats();
+	std::string pathCacheText = Stringf("Path cache: %u entries, %.1f KB, hit rate %.1f%% (%u hits, %u sub-path hits, %u misses, %u evictions, %u invalidations, %u stale inserts)",
+		pathCacheStats.m_numEntries, static_cast<float>(pathCacheStats.m_memoryBytes) / 1024.f, pathCacheStats.GetHitRate() * 100.f,
+		pathCacheStats.m_hits, pathCacheStats.m_subPathHits, pathCacheStats.m_misses, pathCacheStats.m_evictions, pathCacheStats.m_invalidations, pathCacheStats.m_staleInserts);
+	snapshot.m_debugOverlayLines.push_back({ pathCacheText, 120.f, Rgba8::LIGHT_ORANGE });
+
+	std::string pathBatchText = Stringf("Path batching: %s, last batch %d requests in %d jobs", m_isBatchingPathRequests ? "on" : "off", m_lastBatchNumRequests, m_lastBatchNumJobs);
+	snapshot.m_debugOverlayLines.push_back({ pathBatchText, 135.f, Rgba8::LIGHT_ORANGE });
+
+	std::string navigationText = m_navSnapshot->GetRectGraph() ? Stringf("Navigation: rectangles (%d rects), snapshot v%u", m_navSnapshot->GetRectGraph()->GetNumRects(), m_navSnapshot->GetVersion()) : Stringf("Navigation: tiles, snapshot v%u", m_navSnapshot->GetVersion());
+	snapshot.m_debugOverlayLines.push_back({ navigationText, 150.f, Rgba8::LIGHT_ORANGE });
+
+	std::string visibilityText = Stringf("Tile visibility: radius %d, %.1f KB, built in %.2f ms", m_tileVisibility.GetRadius(), static_cast<float>(m_tileVisibility.GetMemoryBytes()) / 1024.f, m_lastVisibilityBuildMS);
+	snapshot.m_debugOverlayLines.push_back({ visibilityText, 165.f, Rgba8::LIGHT_ORANGE });
+
+	std::string perceptionText = Stringf("Perception: %s, %d agents, %d rays, %.3f ms", m_isBatchingPerception ? "batched" : "per AI", m_perception.GetNumAgents(), m_perception.GetNumRaysCast(), m_perception.GetLastUpdateMS());
+	snapshot.m_debugOverlayLines.push_back({ perceptionText, 180.f, Rgba8::LIGHT_ORANGE });
+
+	FrameVisibilityStats visibilityStats = m_visibilityCache.GetStats();
+	std::string visibilityCacheText = Stringf("Sight cache: %u hits, %u misses, %u pairs last frame", visibilityStats.m_hits, visibilityStats.m_misses, visibilityStats.m_numEntries);
+	snapshot.m_debugOverlayLines.push_back({ visibilityCacheText, 195.f, Rgba8::LIGHT_ORANGE });
+
+	std::string squadText = Stringf("Squad: %s, %d seeing player (%d chasing), last seen %.1fs ago", m_squadBlackboard.GetAlertState() == SquadAlertState::ALERTED ? "alerted" : "calm", m_squadBlackboard.GetNumSeeingPlayer(), m_squadBlackboard.GetNumChasersSeeingPlayer(), m_squadBlackboard.HasSeenPlayer() ? (float)m_timers.GetElapsedSeconds() - m_squadBlackboard.GetLastSeenTime() : 0.f);
+	snapshot.m_debugOverlayLines.push_back({ squadText, 210.f, Rgba8::LIGHT_ORANGE });
+
+	std::string alertWaveText = Stringf("Alert waves: %d active, %d tiles reached last frame", m_alertWavefront.GetNumActiveWaves(), m_alertWavefront.GetNumTilesReachedLastUpdate());
+	snapshot.m_debugOverlayLines.push_back({ alertWaveText, 225.f, Rgba8::LIGHT_ORANGE });
+
+	std::string influenceText = Stringf("Influence diffusion: %.3f ms on worker", m_influenceMap.GetLastDiffusionMS());
+	snapshot.m_debugOverlayLines.push_back({ influenceText, 240.f, Rgba8::LIGHT_ORANGE });
+
+	std::string aiLODText = Stringf("AI LOD: %s, near %d, mid %d, asleep %d, %d thinking this frame", m_aiLevelOfDetail.IsEnabled() ? "on" : "off", m_aiLevelOfDetail.GetNumAgentsInTier(AILODTier::NEAR), m_aiLevelOfDetail.GetNumAgentsInTier(AILODTier::MID), m_aiLevelOfDetail.GetNumAgentsInTier(AILODTier::FAR), m_aiLevelOfDetail.GetNumThinkingLastUpdate());
+	snapshot.m_debugOverlayLines.push_back({ aiLODText, 255.f, Rgba8::LIGHT_ORANGE });
+
+	std::string patrolText = Stringf("Patrol network: %s, %d waypoints, %d routes, built in %.2f ms", m_isUsingPatrolNetwork ? "on" : "off", m_patrolNetwork.GetNumWaypoints(), m_patrolNetwork.GetNumEdges(), m_patrolNetwork.GetLastBuildMS());
+	snapshot.m_debugOverlayLines.push_back({ patrolText, 270.f, Rgba8::LIGHT_ORANGE });
+
+	std::string actorGridText = Stringf("Actor grid: %d actors, %d cell changes, %d colliding pairs", m_actorGrid.GetNumEntries(), m_actorGrid.GetNumCellChanges(), static_cast<int>(m_actorPairs.size()));
+	snapshot.m_debugOverlayLines.push_back({ actorGridText, 285.f, Rgba8::LIGHT_ORANGE });
+
+	std::string actorPhysicsText = Stringf("Actor physics: %d rows, %d simulated, %.3f ms", m_actorPhysics.GetNumRows(), m_actorPhysics.GetNumSimulatedRows(), m_actorPhysics.GetLastUpdateMS());
+	snapshot.m_debugOverlayLines.push_back({ actorPhysicsText, 300.f, Rgba8::LIGHT_ORANGE });
+
+	std::string actorUpdateText = Stringf("Actor update: %d AIs thinking in %d slices, %.3f ms, physics in %d slices", static_cast<int>(m_thinkingAIs.size()), m_lastThinkNumJobs, m_lastThinkMS, m_lastIntegrateNumJobs);
+	snapshot.m_debugOverlayLines.push_back({ actorUpdateText, 315.f, Rgba8::LIGHT_ORANGE });
+
+	std::string fixedStepText = m_isUsingFixedStep ? Stringf("Fixed step: %.0f Hz, %d steps this frame (max %d), blend %.2f", 1.f / m_fixedStepSeconds, m_numStepsLastFrame, m_maxStepsPerFrame, m_stepInterpolation) : std::string("Fixed step: off, one variable step per frame");
+	snapshot.m_debugOverlayLines.push_back({ fixedStepText, 330.f, Rgba8::LIGHT_ORANGE });
+
+
+	std::string simulationText = Stringf("Simulation: %s, %.3f ms last frame, main thread waited %.3f ms, %d actors in snapshot", m_simulationThread ? "own thread" : "main thread", m_lastSimulationFrameMS, m_lastSimulationWaitMS, static_cast<int>(snapshot.m_actors.size()));
+	snapshot.m_debugOverlayLines.push_back({ simulationText, 345.f, Rgba8::LIGHT_ORANGE });
+
+	std::string contactText = Stringf("Actor contacts: %d pairs in %d islands (largest %d), %d iterations in %d slices", m_contactIslands.GetNumPairs(), m_contactIslands.GetNumIslands(), m_contactIslands.GetLargestIslandSize(), m_actorCollisionIterations, m_lastCollideNumJobs);
+	snapshot.m_debugOverlayLines.push_back({ contactText, 360.f, Rgba8::LIGHT_ORANGE });
+
+	std::string triggerText = Stringf("Triggers: %d active, %d subscribers, %d moved, %d volumes tested, %d hits", m_triggers.GetNumActiveTriggers(), m_triggers.GetNumSubscribers(), m_triggers.GetNumMovedLastUpdate(), m_triggers.GetNumTestedLastUpdate(), static_cast<int>(m_triggerHits.size()));
+	snapshot.m_debugOverlayLines.push_back({ triggerText, 375.f, Rgba8::LIGHT_ORANGE });
+
+	std::string timerText = Stringf("Timers: %d pending, %d expired and %d moved down a level last step", m_timers.GetNumPending(), m_timers.GetNumExpiredLastAdvance(), m_timers.GetNumCascadedLastAdvance());
+	snapshot.m_debugOverlayLines.push_back({ timerText, 390.f, Rgba8::LIGHT_ORANGE });
+}
+
+RenderSnapshot& Map::GetBuildingSnapshot()
+{
+	return m_renderSnapshots.GetWriteBuffer();
+}
+
+const RenderSnapshot& Map::GetRenderSnapshot() const
+{
+	return m_renderSnapshots.GetReadBuffer();
+}
+
 void Map::UpdateGameLogic()
 {
 	CheckIfPlayerHasReachedAGoalTile();
@@ -685,113 +1018,419 @@ void Map::UpdateGameLogic()
 	{
 		return;
 	}
-	m_gameTime -= m_game->m_clock->GetDeltaSeconds();
+	m_gameTime -= m_stepDeltaSeconds;
 	if (!m_hasPlayerReachedGoal && m_gameTime <= 0.f)
 	{
 		m_gameTime = 0.f;
 	}
 }
 
-void Map::UpdateActors()
+void Map::UpdatePerception()
 {
-	for (int index = 0; index < m_actors.size(); index++)
+	if (m_hasPlayerReachedGoal)
 	{
-		if (m_actors[index] == nullptr)
-		{
-			continue;
-		}
-		m_actors[index]->Update();
+		return;
+	}
+
+	if (m_isBatchingPerception)
+	{
+		m_perception.Update(this);
 	}
+	m_squadBlackboard.Update(this, (float)m_timers.GetElapsedSeconds());
 }
 
-void Map::GetMaxNumberSpawnedEnemyActors()
+void Map::UpdateSquadAlerts()
 {
-	for (int i = 0; i < m_actors.size(); i++)
+	if (m_hasPlayerReachedGoal)
 	{
-		if (m_actors[i] != nullptr)
-		{
-			if (m_actors[i]->m_isAI)
-			{
-				m_numEnemyActors.emplace_back(m_actors[i]);
-			}
-		}
+		return;
 	}
+	m_alertWavefront.Update(*m_navSnapshot, m_stepDeltaSeconds);
 }
 
-Actor* Map::GetItemActor()
+void Map::UpdateInfluenceMap()
 {
-	for (int actor = 0; actor < m_actors.size(); actor++)
+	if (m_hasPlayerReachedGoal)
 	{
-		if (m_actors[actor] != nullptr)
-		{
-			if (m_actors[actor]->GetType() == ActorType::ACTOR_ITEMBOX)
-			{
-				return m_actors[actor];
-			}
-		}
+		return;
 	}
-	return nullptr;
+	m_influenceMap.Update(this);
 }
 
-Actor* Map::GetPlayerActor()
+void Map::UpdateAILevelOfDetail()
 {
-	for (int actor = 0; actor < m_actors.size(); actor++)
+	m_aiLevelOfDetail.Update(this);
+}
+
+void Map::UpdateActors()
+{
+	// AI decisions only read the rest of the map, so they run across the workers first. What they do to other
+	// actors or shared state is applied afterwards in actor order, which keeps the result independent of how
+	// the agents were split. The per-agent fallback is kept for ray-cast perception, which writes a shared cache
+	m_isThinkingAIsInPhases = m_isUpdatingActorsInParallel && m_isBatchingPerception;
+	if (m_isThinkingAIsInPhases)
 	{
-		if (m_actors[actor] != nullptr)
+		auto thinkStart = std::chrono::high_resolution_clock::now();
+
+		m_thinkingAIs.clear();
+		for (Actor* actor : m_actors)
 		{
-			if (m_actors[actor]->GetType() == ActorType::ACTOR_PLAYER)
+			if (actor->m_isVisible && !actor->m_isItem && actor->IsControlledByAI())
 			{
-				return m_actors[actor];
+				m_thinkingAIs.push_back(actor->GetAiController());
 			}
 		}
+		m_lastThinkNumJobs = RunActorUpdatePhase(ActorUpdatePhase::THINK, static_cast<int>(m_thinkingAIs.size()));
+		for (AIActor* aiController : m_thinkingAIs)
+		{
+			aiController->ApplyCommands();
+		}
+
+		auto thinkEnd = std::chrono::high_resolution_clock::now();
+		m_lastThinkMS = std::chrono::duration<float, std::milli>(thinkEnd - thinkStart).count();
+	}
+
+	for (int index = 0; index < m_actors.size(); index++)
+	{
+		if (m_actors[index] == nullptr)
+		{
+			continue;
+		}
+		m_actors[index]->Update();
 	}
-	return nullptr;
 }
 
-ActorUID Map::GenerateActorUID(int actorIndex)
+void Map::UpdateActorPhysics()
 {
-	ActorUID uid = ActorUID(m_actorSalt++, actorIndex);
-	return uid;
-}
+	m_actorPhysics.BeginUpdate();
+	m_lastIntegrateNumJobs = RunActorUpdatePhase(ActorUpdatePhase::INTEGRATE, m_actorPhysics.GetNumRows());
+	m_actorPhysics.EndUpdate();
 
+	for (Actor* actor : m_actors)
+	{
+		UpdateActorInGrid(actor);
+	}
+}
 
-void Map::CollideActors()
+int Map::RunActorUpdatePhase(ActorUpdatePhase phase, int numItems)
 {
-	for (int actorIndexA = 0; actorIndexA < m_actors.size(); actorIndexA++)
+	float deltaSeconds = m_stepDeltaSeconds;
+	// The workers plus the main thread, which runs a slice of its own below
+	int numThreads = g_theApp->m_numJobWorkers + 1;
+	int numSlices = 1;
+	if (m_isUpdatingActorsInParallel)
 	{
-		Actor* actorA = m_actors[actorIndexA];
+		numSlices = std::max(1, std::min(numThreads, numItems / std::max(1, m_minActorsPerUpdateJob)));
+	}
 
-		for (int actorIndexB = actorIndexA + 1; actorIndexB < m_actors.size(); actorIndexB++)
+	// Every slice but the last goes to the workers, the main thread takes the last one instead of sitting idle
+	int numQueuedSlices = 0;
+	int firstIndex = 0;
+	for (int slice = 0; slice < numSlices - 1; slice++)
+	{
+		int lastIndex = firstIndex + (numItems - firstIndex) / (numSlices - slice);
+		if (phase == ActorUpdatePhase::INTEGRATE)
 		{
-			Actor* actorB = m_actors[actorIndexB];
+			// Physics rows are written four at a time, two slices must never share a block
+			lastIndex = std::min((lastIndex + 3) & ~3, numItems);
+		}
+		g_theJobSystem->QueueJob(new ActorUpdateJob(this, phase, firstIndex, lastIndex, deltaSeconds));
+		numQueuedSlices++;
+		firstIndex = lastIndex;
+	}
 
-			if (!actorA || !actorB) continue;
+	ActorUpdateJob mainThreadSlice(this, phase, firstIndex, numItems, deltaSeconds);
+	mainThreadSlice.Execute();
 
-			if ((actorA->m_type == ActorType::ACTOR_ITEMBOX && actorB->m_type == ActorType::ACTOR_ENEMY) || (actorA->m_type == ActorType::ACTOR_ENEMY && actorB->m_type == ActorType::ACTOR_ITEMBOX)) continue;
+	// Other jobs finishing in the meantime are held back, a path delivered now would land on an AI mid think
+	while (numQueuedSlices > 0)
+	{
+		Job* completedJob = g_theJobSystem->RetrieveCompletedJob();
+		if (completedJob == nullptr)
+		{
+			std::this_thread::yield();
+			continue;
+		}
 
-			CollideActors(actorA, actorB);
+		if (dynamic_cast<ActorUpdateJob*>(completedJob))
+		{
+			numQueuedSlices--;
+			delete completedJob;
+		}
+		else
+		{
+			m_deferredCompletedJobs.push_back(completedJob);
 		}
 	}
+	return numSlices;
 }
 
-void Map::CollideActors(Actor* actorA, Actor* actorB)
+void Map::QueueBatchedPathfindingJobs()
 {
-	FloatRange actorARange(actorA->m_position.z, actorA->m_position.z + actorA->m_physicsHeight);
-	FloatRange actorBRange(actorB->m_position.z, actorB->m_position.z + actorB->m_physicsHeight);
+	if (m_pendingPathRequests.empty())
+	{
+		return;
+	}
 
-	if (actorARange.IsOverlapingWith(actorBRange))
+	// One job per worker thread, each taking a contiguous slice of this frame's requests
+	int numWorkers = g_theApp->m_numJobWorkers;
+	int numRequests = static_cast<int>(m_pendingPathRequests.size());
+	int numJobs = std::max(1, std::min(numWorkers, numRequests));
+
+	int firstRequest = 0;
+	for (int jobIndex = 0; jobIndex < numJobs; jobIndex++)
 	{
-		if (DoDiscsOverlap(Vec2(actorA->m_position.x, actorA->m_position.y), actorA->m_physicsRadius, Vec2(actorB->m_position.x, actorB->m_position.y), actorB->m_physicsRadius))
-		{
-			Vec2 actorAPosXY = Vec2(actorA->m_position.x, actorA->m_position.y);
-			Vec2 actorBPosXY = Vec2(actorB->m_position.x, actorB->m_position.y);
+		int numRequestsInJob = (numRequests - firstRequest) / (numJobs - jobIndex);
+		auto first = m_pendingPathRequests.begin() + firstRequest;
+		AStarBatchJob* job = new AStarBatchJob(m_navSnapshot, m_pathCache, first, first + numRequestsInJob);
+		g_theJobSystem->QueueJob(job);
+		firstRequest += numRequestsInJob;
+	}
 
-			if (actorA->m_canCollideWithActors && actorB->m_canCollideWithActors)
-			{
-				PushDiscOutOfEachOther2D(actorAPosXY, actorA->m_physicsRadius, actorBPosXY, actorB->m_physicsRadius);
+	m_lastBatchNumRequests = numRequests;
+	m_lastBatchNumJobs = numJobs;
+	m_pendingPathRequests.clear();
+}
 
-				if (actorA->m_ownerUID.IsValid() || actorB->m_ownerUID.IsValid())
-				{
+void Map::RetrieveCompletedPathfindingJobs()
+{
+	// Jobs that finished while the actor update was waiting on its own slices were held back until now
+	for (Job* completedJob : m_deferredCompletedJobs)
+	{
+		HandleCompletedJob(completedJob);
+	}
+	m_deferredCompletedJobs.clear();
+
+	while (true)
+	{
+		Job* completedJob = g_theJobSystem->RetrieveCompletedJob();
+		if (!completedJob) break;
+		HandleCompletedJob(completedJob);
+	}
+}
+
+void Map::HandleCompletedJob(Job* completedJob)
+{
+	// Jobs queued by a map that has since been torn down are dropped here
+	if (AStarBatchJob* batchJob = dynamic_cast<AStarBatchJob*>(completedJob))
+	{
+		if (batchJob->m_navSnapshot->GetMapID() == m_mapID)
+		{
+			batchJob->PublishResults(this);
+		}
+	}
+	else if (AStarPathfindingJob* pathingJob = dynamic_cast<AStarPathfindingJob*>(completedJob))
+	{
+		if (pathingJob->m_navSnapshot->GetMapID() == m_mapID)
+		{
+			DeliverPath(pathingJob->m_request.m_aiUID, pathingJob->m_resultPath.data(), pathingJob->m_resultPath.size());
+		}
+	}
+	else if (InfluenceDiffusionJob* diffusionJob = dynamic_cast<InfluenceDiffusionJob*>(completedJob))
+	{
+		// The influence map reuses its job every tick, only one left behind by an old map is deleted
+		if (diffusionJob->m_mapID == m_mapID)
+		{
+			m_influenceMap.OnDiffusionJobCompleted();
+			return;
+		}
+	}
+	delete completedJob;
+}
+
+void Map::DeliverPath(const ActorUID& aiUID, const IntVec2* waypoints, size_t numWaypoints)
+{
+	// The requesting AI may have died while its path was being computed
+	Actor* actor = GetActorByUID(aiUID);
+	if (actor == nullptr || actor->GetAiController() == nullptr)
+	{
+		return;
+	}
+	actor->GetAiController()->ReceivePath(waypoints, numWaypoints);
+}
+
+void Map::GetMaxNumberSpawnedEnemyActors()
+{
+	for (int i = 0; i < m_actors.size(); i++)
+	{
+		if (m_actors[i] != nullptr)
+		{
+			if (m_actors[i]->m_isAI)
+			{
+				m_numEnemyActors.emplace_back(m_actors[i]);
+			}
+		}
+	}
+}
+
+Actor* Map::GetItemActor()
+{
+	for (int actor = 0; actor < m_actors.size(); actor++)
+	{
+		if (m_actors[actor] != nullptr)
+		{
+			if (m_actors[actor]->GetType() == ActorType::ACTOR_ITEMBOX)
+			{
+				return m_actors[actor];
+			}
+		}
+	}
+	return nullptr;
+}
+
+Actor* Map::GetPlayerActor()
+{
+	for (int actor = 0; actor < m_actors.size(); actor++)
+	{
+		if (m_actors[actor] != nullptr)
+		{
+			if (m_actors[actor]->GetType() == ActorType::ACTOR_PLAYER)
+			{
+				return m_actors[actor];
+			}
+		}
+	}
+	return nullptr;
+}
+
+ActorUID Map::GenerateActorUID()
+{
+	unsigned int slotIndex = 0;
+	if (!m_freeActorSlots.empty())
+	{
+		slotIndex = m_freeActorSlots.back();
+		m_freeActorSlots.pop_back();
+	}
+	else
+	{
+		slotIndex = static_cast<unsigned int>(m_actorSlots.size());
+		m_actorSlots.emplace_back();
+	}
+	return ActorUID(m_actorSlots[slotIndex].m_generation, slotIndex);
+}
+
+void Map::AddActor(Actor* actor)
+{
+	m_actorSlots[actor->GetUID().GetIndex()].m_denseIndex = static_cast<int>(m_actors.size());
+	m_actors.emplace_back(actor);
+	actor->m_previousPosition = actor->m_position;
+	actor->m_previousOrientation = actor->m_orientation;
+	m_actorPhysics.AddRow(actor->m_dragForce);
+
+	// Items only go in the trigger table, nothing looks at them unless the player is standing over one
+	if (actor->m_isItem)
+	{
+		actor->m_item->m_triggerIndex = m_triggers.AddTrigger(Vec2(actor->m_position.x, actor->m_position.y), actor->m_physicsRadius, actor->m_item->GetTriggerHeightRange(actor->m_physicsHeight), actor->GetUID());
+		return;
+	}
+	m_actorGrid.InsertEntry(actor->GetUID().GetIndex(), Vec2(actor->m_position.x, actor->m_position.y), actor->m_physicsRadius);
+	if (actor->m_type == ActorType::ACTOR_PLAYER)
+	{
+		m_triggers.Subscribe(actor->GetUID());
+	}
+}
+
+bool Map::IsActorAtPosition(const Vec3& position)
+{
+	m_actorGrid.QueryRadius(Vec2(position.x, position.y), 0.f, m_actorQueryResults);
+	for (unsigned int slotIndex : m_actorQueryResults)
+	{
+		if (GetActorInSlot(slotIndex)->GetActorPosition() == position)
+		{
+			return true;
+		}
+	}
+	return m_triggers.IsAnyTriggerCenteredAt(Vec2(position.x, position.y));
+}
+
+Actor* Map::GetActorInSlot(unsigned int slotIndex) const
+{
+	return m_actors[m_actorSlots[slotIndex].m_denseIndex];
+}
+
+int Map::GetActorRow(const ActorUID& uid) const
+{
+	unsigned int slotIndex = uid.GetIndex();
+	if (slotIndex >= m_actorSlots.size() || m_actorSlots[slotIndex].m_generation != uid.GetGeneration())
+	{
+		return -1;
+	}
+	return m_actorSlots[slotIndex].m_denseIndex;
+}
+
+void Map::UpdateActorInGrid(const Actor* actor)
+{
+	m_actorGrid.UpdateEntry(actor->GetUID().GetIndex(), Vec2(actor->m_position.x, actor->m_position.y));
+}
+
+
+void Map::CollideActors()
+{
+	GatherActorContacts();
+	m_lastCollideNumJobs = RunActorUpdatePhase(ActorUpdatePhase::COLLIDE, m_contactIslands.GetNumIslands());
+
+	// The grid is not safe to move entries in from several threads, so it catches up once every island is done
+	for (const std::pair<unsigned int, unsigned int>& actorPair : m_actorPairs)
+	{
+		UpdateActorInGrid(GetActorInSlot(actorPair.first));
+		UpdateActorInGrid(GetActorInSlot(actorPair.second));
+	}
+}
+
+void Map::GatherActorContacts()
+{
+	// Only pairs whose discs overlap come back from the grid, pushes made here are not re-queried until next frame
+	m_actorGrid.GatherOverlappingPairs(m_actorPairs);
+
+	// Pairs that can never push each other are dropped so they do not join two islands together
+	size_t numKeptPairs = 0;
+	for (const std::pair<unsigned int, unsigned int>& actorPair : m_actorPairs)
+	{
+		Actor* actorA = GetActorInSlot(actorPair.first);
+		Actor* actorB = GetActorInSlot(actorPair.second);
+
+		if (!actorA->m_canCollideWithActors || !actorB->m_canCollideWithActors) continue;
+		if ((actorA->m_ownerUID.IsValid() || actorB->m_ownerUID.IsValid()) && (actorA->m_uid == actorB->m_ownerUID || actorB->m_uid == actorA->m_ownerUID || actorA->m_ownerUID == actorB->m_ownerUID)) continue;
+
+		m_actorPairs[numKeptPairs++] = actorPair;
+	}
+	m_actorPairs.resize(numKeptPairs);
+	m_contactIslands.Build(m_actorPairs, static_cast<int>(m_actorSlots.size()));
+}
+
+void Map::ResolveContactIsland(int islandIndex)
+{
+	// Runs on any thread; every actor in an island belongs to it alone
+	int numPairs = 0;
+	const int* pairIndexes = m_contactIslands.GetIslandPairs(islandIndex, numPairs);
+	for (int iteration = 0; iteration < m_actorCollisionIterations; iteration++)
+	{
+		for (int index = 0; index < numPairs; index++)
+		{
+			int pairIndex = pairIndexes[index];
+			CollideActors(GetActorInSlot(m_actorPairs[pairIndex].first), GetActorInSlot(m_actorPairs[pairIndex].second));
+		}
+	}
+}
+
+void Map::CollideActors(Actor* actorA, Actor* actorB)
+{
+	FloatRange actorARange(actorA->m_position.z, actorA->m_position.z + actorA->m_physicsHeight);
+	FloatRange actorBRange(actorB->m_position.z, actorB->m_position.z + actorB->m_physicsHeight);
+
+	if (actorARange.IsOverlapingWith(actorBRange))
+	{
+		if (DoDiscsOverlap(Vec2(actorA->m_position.x, actorA->m_position.y), actorA->m_physicsRadius, Vec2(actorB->m_position.x, actorB->m_position.y), actorB->m_physicsRadius))
+		{
+			Vec2 actorAPosXY = Vec2(actorA->m_position.x, actorA->m_position.y);
+			Vec2 actorBPosXY = Vec2(actorB->m_position.x, actorB->m_position.y);
+
+			if (actorA->m_canCollideWithActors && actorB->m_canCollideWithActors)
+			{
+				PushDiscOutOfEachOther2D(actorAPosXY, actorA->m_physicsRadius, actorBPosXY, actorB->m_physicsRadius);
+
+				if (actorA->m_ownerUID.IsValid() || actorB->m_ownerUID.IsValid())
+				{
 					if (actorA->m_uid == actorB->m_ownerUID || actorB->m_uid == actorA->m_ownerUID || actorA->m_ownerUID == actorB->m_ownerUID)
 					{
 						return;
@@ -800,21 +1439,115 @@ void Map::CollideActors(Actor* actorA, Actor* actorB)
 
 				actorA->m_position = Vec3(actorAPosXY.x, actorAPosXY.y, actorA->m_position.z);
 				actorB->m_position = Vec3(actorBPosXY.x, actorBPosXY.y, actorB->m_position.z);
+			}
+		}
+	}
+}
 
-				if (actorA->IsPlayer() && actorB->IsItem())
-				{
-					if (actorB->IsAlive())
-					{
-						actorB->OnCollide();
-					}
-				}
+void Map::ValidateContactIslands(std::vector<std::string>& outLines)
+{
+	// Actors are crowded around the player so islands are large, then the islands resolved across all threads must
+	// land every actor exactly where resolving the same pairs one by one on this thread does. Everything is put back after,
+	// and the crowd comes from its own generator so the game's random stream is left alone too.
+	RandomNumberGenerator rng;
+	std::vector<Vec3> savedPositions;
+	for (Actor* actor : m_actors)
+	{
+		savedPositions.push_back(actor->m_position);
+	}
+	int savedIterations = m_actorCollisionIterations;
+	int savedActorsPerJob = m_minActorsPerUpdateJob;
+	m_minActorsPerUpdateJob = 1;
+
+	Actor* player = GetPlayerActor();
+	Vec2 crowdCenter = player ? Vec2(player->m_position.x, player->m_position.y) : Vec2(0.5f * m_dimensions.x, 0.5f * m_dimensions.y);
+	float crowdHalfSize = std::max(1.f, 0.25f * sqrtf(static_cast<float>(m_actors.size())));
+
+	constexpr int NUM_TRIALS = 50;
+	int numMismatches = 0;
+	int numPairs = 0;
+	int numIslands = 0;
+	int largestIsland = 0;
+	std::vector<Vec3> crowdPositions(m_actors.size());
+	std::vector<Vec3> serialPositions(m_actors.size());
+	for (int trial = 0; trial < NUM_TRIALS; trial++)
+	{
+		m_actorCollisionIterations = 1 + trial % 4;
+		for (int actorIndex = 0; actorIndex < m_actors.size(); actorIndex++)
+		{
+			Actor* actor = m_actors[actorIndex];
+			actor->m_position.x = crowdCenter.x + rng.RollRandomFloatInRange(-crowdHalfSize, crowdHalfSize);
+			actor->m_position.y = crowdCenter.y + rng.RollRandomFloatInRange(-crowdHalfSize, crowdHalfSize);
+			crowdPositions[actorIndex] = actor->m_position;
+			UpdateActorInGrid(actor);
+		}
+		GatherActorContacts();
+		numPairs += m_contactIslands.GetNumPairs();
+		numIslands += m_contactIslands.GetNumIslands();
+		largestIsland = std::max(largestIsland, m_contactIslands.GetLargestIslandSize());
+
+		for (int iteration = 0; iteration < m_actorCollisionIterations; iteration++)
+		{
+			for (const std::pair<unsigned int, unsigned int>& actorPair : m_actorPairs)
+			{
+				CollideActors(GetActorInSlot(actorPair.first), GetActorInSlot(actorPair.second));
+			}
+		}
+		for (int actorIndex = 0; actorIndex < m_actors.size(); actorIndex++)
+		{
+			serialPositions[actorIndex] = m_actors[actorIndex]->m_position;
+			m_actors[actorIndex]->m_position = crowdPositions[actorIndex];
+		}
+
+		RunActorUpdatePhase(ActorUpdatePhase::COLLIDE, m_contactIslands.GetNumIslands());
+		for (int actorIndex = 0; actorIndex < m_actors.size(); actorIndex++)
+		{
+			const Vec3& islandPosition = m_actors[actorIndex]->m_position;
+			if (islandPosition.x != serialPositions[actorIndex].x || islandPosition.y != serialPositions[actorIndex].y || islandPosition.z != serialPositions[actorIndex].z)
+			{
+				numMismatches++;
 			}
 		}
 	}
+
+	for (int actorIndex = 0; actorIndex < m_actors.size(); actorIndex++)
+	{
+		m_actors[actorIndex]->m_position = savedPositions[actorIndex];
+		UpdateActorInGrid(m_actors[actorIndex]);
+	}
+	m_actorCollisionIterations = savedIterations;
+	m_minActorsPerUpdateJob = savedActorsPerJob;
+	GatherActorContacts();
+
+	outLines.push_back(Stringf("Contact islands: %d crowds of %d actors, %d pairs in %d islands, largest island %d pairs", NUM_TRIALS, static_cast<int>(m_actors.size()), numPairs, numIslands, largestIsland));
+	outLines.push_back(Stringf("Contact islands: %d actor positions differ from resolving the pairs in order", numMismatches));
+}
+
+void Map::UpdateTriggers()
+{
+	// Runs on final positions for the step, after actors and walls have pushed everyone where they end up
+	m_triggers.Update(*this, m_triggerHits);
+	for (const TriggerHit& hit : m_triggerHits)
+	{
+		Actor* owner = GetActorByUID(hit.m_ownerUID);
+		if (owner && owner->IsItem() && owner->IsAlive())
+		{
+			owner->OnCollide();
+			// The freed index can go to another item before this one is deleted, so it must not be removed again then
+			m_triggers.RemoveTrigger(hit.m_triggerIndex);
+			owner->m_item->m_triggerIndex = -1;
+		}
+	}
 }
 
 void Map::CollideActorsWithMap()
 {
+	if (m_isSweepingWallCollision)
+	{
+		SweepActorsAgainstWalls();
+		return;
+	}
+
 	for (int actor = 0; actor < m_actors.size(); actor++)
 	{
 		if (m_actors[actor] == nullptr)
@@ -834,11 +1567,35 @@ void Map::CollideActorsWithMap()
 			if (PushActorOutOfWalls(m_actors[actor], tileBounds))
 			{
 				didCollide |= true;
+				UpdateActorInGrid(m_actors[actor]);
 			}
 		}
 	}
 }
 
+void Map::SweepActorsAgainstWalls()
+{
+	// The whole of this step's move is traced, so a fast actor or a long step cannot carry anyone through a wall
+	SweptDiscCollision wallSweep(m_dimensions, m_navSnapshot->GetSolidTiles(), m_wallDistance);
+	for (Actor* actor : m_actors)
+	{
+		if (!actor->m_canCollideWithWorld)
+		{
+			continue;
+		}
+
+		Vec2 start(actor->m_previousPosition.x, actor->m_previousPosition.y);
+		Vec2 end(actor->m_position.x, actor->m_position.y);
+		DiscSweepResult sweep = wallSweep.SweepAndSlide(start, end - start, actor->m_physicsRadius);
+		if (sweep.m_position.x != end.x || sweep.m_position.y != end.y)
+		{
+			actor->m_position.x = sweep.m_position.x;
+			actor->m_position.y = sweep.m_position.y;
+			UpdateActorInGrid(actor);
+		}
+	}
+}
+
 bool  Map::PushActorOutOfWalls(Actor* actor, const AABB2& tileBounds) const
 {
 	Vec2 actorPosition2D(actor->m_position.x, actor->m_position.y);
@@ -910,6 +1667,129 @@ RaycastResult Map::RaycastAll(Actor* actor, const Vec3& start, const Vec3& direc
 	return closestResult;
 }
 
+RaycastResult Map::RaycastWorldXYWallDistanceSkip(const Vec3& start, const Vec3& direction, float distance) const
+{
+	RaycastResult result;
+	result.m_rayStartPos = start;
+	result.m_rayFwdNormal = direction;
+	result.m_rayMaxLength = distance;
+
+	IntVec2 currentTileXY = IntVec2(RoundDownToInt(start.x), RoundDownToInt(start.y));
+	if (IsSolidTile(currentTileXY.x, currentTileXY.y) && AreCoordsInBounds(currentTileXY.x, currentTileXY.y))
+	{
+		if (!(start.z > 1.f || start.z < 0.f))
+		{
+			result.m_didImpact = true;
+			result.m_impactPos = start;
+			result.m_impactDist = 0.f;
+			result.m_impactNormal = direction * -1.f;
+			return result;
+		}
+	}
+
+	// Tiles closer to the last checked tile than its wall distance cannot be solid, so crossings into them skip the lookup.
+	// The crossing distances are still accumulated one tile at a time so every result matches the plain grid walk exactly
+	IntVec2 wallFreeMins;
+	IntVec2 wallFreeMaxs;
+	auto updateWallFreeBox = [&]()
+	{
+		int wallDistance = m_wallDistance.GetDistance(currentTileXY.x, currentTileXY.y);
+		wallFreeMins = currentTileXY - IntVec2(wallDistance - 1, wallDistance - 1);
+		wallFreeMaxs = currentTileXY + IntVec2(wallDistance - 1, wallDistance - 1);
+	};
+	auto isInWallFreeBox = [&]()
+	{
+		return currentTileXY.x >= wallFreeMins.x && currentTileXY.x <= wallFreeMaxs.x && currentTileXY.y >= wallFreeMins.y && currentTileXY.y <= wallFreeMaxs.y;
+	};
+	updateWallFreeBox();
+
+	// X
+	float fwdDistPerXCrossing = 1.f / abs(direction.x);
+	int tileStepDirectionX = (direction.x > 0) ? 1 : -1;
+	float xAtFirstXCrossing = currentTileXY.x + (tileStepDirectionX + 1) / 2.f;
+	float xDistToFirstXCrossing = xAtFirstXCrossing - start.x;
+	float fwdDistAtNextXCrossing = fabsf(xDistToFirstXCrossing) * fwdDistPerXCrossing;
+
+	// Y
+	float fwdDistPerYCrossing = 1.f / abs(direction.y);
+	int tileStepDirectionY = (direction.y > 0) ? 1 : -1;
+	float yAtFirstYCrossing = currentTileXY.y + (tileStepDirectionY + 1) / 2.f;
+	float yDistToFirstYCrossing = yAtFirstYCrossing - start.y;
+	float fwdDistAtNextYCrossing = fabsf(yDistToFirstYCrossing) * fwdDistPerYCrossing;
+
+	for (;;)
+	{
+		if (fwdDistAtNextXCrossing < fwdDistAtNextYCrossing)
+		{
+			if (fwdDistAtNextXCrossing > distance)
+			{
+				result.m_didImpact = false;
+				return result;
+			}
+			currentTileXY.x += tileStepDirectionX;
+			if (isInWallFreeBox())
+			{
+				fwdDistAtNextXCrossing += fwdDistPerXCrossing;
+				continue;
+			}
+			if (IsSolidTile(currentTileXY.x, currentTileXY.y) && AreCoordsInBounds(currentTileXY.x, currentTileXY.y))
+			{
+				result.m_impactTileCoord = IntVec2(currentTileXY.x, currentTileXY.y);
+				result.m_didImpact = true;
+				result.m_impactDist = fwdDistAtNextXCrossing;
+				result.m_impactPos = start + direction * result.m_impactDist;
+				if (result.m_impactPos.z > 1.f || result.m_impactPos.z < 0)
+				{
+					result.m_didImpact = false;
+					fwdDistAtNextXCrossing += fwdDistPerXCrossing;
+					continue;
+				}
+				result.m_impactNormal = Vec3(static_cast<float>(-tileStepDirectionX), 0.f, 0.f);
+				return result;
+			}
+			else
+			{
+				updateWallFreeBox();
+				fwdDistAtNextXCrossing += fwdDistPerXCrossing;
+			}
+		}
+		else
+		{
+			if (fwdDistAtNextYCrossing > distance)
+			{
+				result.m_didImpact = false;
+				return result;
+			}
+			currentTileXY.y += tileStepDirectionY;
+			if (isInWallFreeBox())
+			{
+				fwdDistAtNextYCrossing += fwdDistPerYCrossing;
+				continue;
+			}
+			if (IsSolidTile(currentTileXY.x, currentTileXY.y) && AreCoordsInBounds(currentTileXY.x, currentTileXY.y))
+			{
+				result.m_impactTileCoord = IntVec2(currentTileXY.x, currentTileXY.y);
+				result.m_didImpact = true;
+				result.m_impactDist = fwdDistAtNextYCrossing;
+				result.m_impactPos = start + direction * result.m_impactDist;
+				if (result.m_impactPos.z > 1.f || result.m_impactPos.z < 0)
+				{
+					result.m_didImpact = false;
+					fwdDistAtNextYCrossing += fwdDistPerYCrossing;
+					continue;
+				}
+				result.m_impactNormal = Vec3(0.f, static_cast<float>(-tileStepDirectionY), 0.f);
+				return result;
+			}
+			else
+			{
+				updateWallFreeBox();
+				fwdDistAtNextYCrossing += fwdDistPerYCrossing;
+			}
+		}
+	}
+}
+
 RaycastResult Map::RaycastWorldXY(const Vec3& start, const Vec3& direction, float distance) const
 {
 	RaycastResult result;
@@ -1005,31 +1885,79 @@ RaycastResult Map::RaycastWorldXY(const Vec3& start, const Vec3& direction, floa
 	}
 }
 
+void Map::ValidateWallDistanceRaycasts(int numRays, std::vector<std::string>& outLines) const
+{
+	// Times the wall distance skip against the plain walk RaycastWorldXY uses, on random rays from inside and just outside the map,
+	// and compares the results bit for bit (rays starting on a tile edge give NaN distances in both).
+	// Own generator so running this mid game leaves the game's random stream alone
+	RandomNumberGenerator rng;
+	std::vector<Vec3> starts(numRays);
+	std::vector<Vec3> directions(numRays);
+	std::vector<float> distances(numRays);
+	for (int rayIndex = 0; rayIndex < numRays; rayIndex++)
+	{
+		starts[rayIndex] = Vec3(rng.RollRandomFloatInRange(-2.f, (float)m_dimensions.x + 2.f), rng.RollRandomFloatInRange(-2.f, (float)m_dimensions.y + 2.f), rng.RollRandomFloatInRange(-0.25f, 1.25f));
+		float yawDegrees = rng.RollRandomFloatInRange(0.f, 360.f);
+		directions[rayIndex] = Vec3(CosDegrees(yawDegrees), SinDegrees(yawDegrees), rng.RollRandomFloatInRange(-0.1f, 0.1f));
+		distances[rayIndex] = rng.RollRandomFloatInRange(0.f, (float)(m_dimensions.x + m_dimensions.y));
+	}
+
+	std::vector<RaycastResult> fieldResults(numRays);
+	std::vector<RaycastResult> exactResults(numRays);
+	auto fieldStart = std::chrono::high_resolution_clock::now();
+	for (int rayIndex = 0; rayIndex < numRays; rayIndex++)
+	{
+		fieldResults[rayIndex] = RaycastWorldXYWallDistanceSkip(starts[rayIndex], directions[rayIndex], distances[rayIndex]);
+	}
+	auto fieldEnd = std::chrono::high_resolution_clock::now();
+	for (int rayIndex = 0; rayIndex < numRays; rayIndex++)
+	{
+		exactResults[rayIndex] = RaycastWorldXY(starts[rayIndex], directions[rayIndex], distances[rayIndex]);
+	}
+	auto exactEnd = std::chrono::high_resolution_clock::now();
+
+	int numMismatches = 0;
+	for (int rayIndex = 0; rayIndex < numRays; rayIndex++)
+	{
+		const RaycastResult& fieldResult = fieldResults[rayIndex];
+		const RaycastResult& exactResult = exactResults[rayIndex];
+		bool isMatching = fieldResult.m_didImpact == exactResult.m_didImpact && fieldResult.m_impactTileCoord == exactResult.m_impactTileCoord;
+		isMatching = isMatching && memcmp(&fieldResult.m_impactDist, &exactResult.m_impactDist, sizeof(float)) == 0;
+		isMatching = isMatching && memcmp(&fieldResult.m_impactPos, &exactResult.m_impactPos, sizeof(Vec3)) == 0 && memcmp(&fieldResult.m_impactNormal, &exactResult.m_impactNormal, sizeof(Vec3)) == 0;
+		numMismatches += isMatching ? 0 : 1;
+	}
+
+	float fieldMS = std::chrono::duration<float, std::milli>(fieldEnd - fieldStart).count();
+	float exactMS = std::chrono::duration<float, std::milli>(exactEnd - fieldEnd).count();
+	outLines.push_back(Stringf("Wall distance raycasts: %d random rays, %d differ from the plain grid walk", numRays, numMismatches));
+	outLines.push_back(Stringf("   plain walk: %.3f ms, with wall distance skip: %.3f ms (%.2fx)", exactMS, fieldMS, fieldMS > 0.f ? exactMS / fieldMS : 0.f));
+}
+
 RaycastResult Map::RaycastWorldActors(Actor* actor, const Vec3& start, const Vec3& direction, float distance) const
 {
 	RaycastResult closestResult;
 	closestResult.m_impactDist = distance;
 
-	for (int numActor = 0; numActor < m_actors.size(); numActor++)
+	// Only actors near the cells the ray passes over are tested
+	std::vector<unsigned int> candidateSlots;
+	m_actorGrid.GatherRayCandidates(Vec2(start.x, start.y), Vec2(direction.x, direction.y), distance, candidateSlots);
+	for (unsigned int slotIndex : candidateSlots)
 	{
-		if (m_actors[numActor] == nullptr)
+		Actor* otherActor = GetActorInSlot(slotIndex);
+		if (otherActor == actor)
 		{
 			continue;
 		}
-		if (m_actors[numActor] == actor)
-		{
-			continue;
-		}
-		Vec2 actorXYPos = Vec2(m_actors[numActor]->m_position.x, m_actors[numActor]->m_position.y);
+		Vec2 actorXYPos = Vec2(otherActor->m_position.x, otherActor->m_position.y);
 
-		RaycastResult3D result3D = RaycastVsZCylinder(start, direction, distance, actorXYPos, FloatRange(m_actors[numActor]->m_position.z, m_actors[numActor]->m_position.z + m_actors[numActor]->m_physicsHeight), m_actors[numActor]->m_physicsRadius);
+		RaycastResult3D result3D = RaycastVsZCylinder(start, direction, distance, actorXYPos, FloatRange(otherActor->m_position.z, otherActor->m_position.z + otherActor->m_physicsHeight), otherActor->m_physicsRadius);
 		if (result3D.m_didImpact && result3D.m_impactDist < closestResult.m_impactDist)
 		{
 			closestResult.m_didImpact = result3D.m_didImpact;
 			closestResult.m_impactDist = result3D.m_impactDist;
 			closestResult.m_impactPos = result3D.m_impactPos;
 			closestResult.m_impactNormal = result3D.m_impactNormal;
-			closestResult.m_impactedActor = m_actors[numActor];
+			closestResult.m_impactedActor = otherActor;
 		}
 	}
 
@@ -1038,23 +1966,9 @@ RaycastResult Map::RaycastWorldActors(Actor* actor, const Vec3& start, const Vec
 
 Actor* Map::SpawnActor(const SpawnInfo& spawnInfo)
 {
-	for (int i = 0; i < m_actors.size(); i++)
-	{
-		if (m_actors[i] == nullptr)
-		{
-			ActorUID uid = GenerateActorUID(i);
-
-			Actor* newActor = new Actor(this, spawnInfo, uid);
-			m_actors[i] = newActor;
-			return newActor;
-		}
-	}
-	int index = static_cast<int>(m_actors.size());
-	ActorUID uid = GenerateActorUID(index);
-
+	ActorUID uid = GenerateActorUID();
 	Actor* newActor = new Actor(this, spawnInfo, uid);
-
-	m_actors.emplace_back(newActor);
+	AddActor(newActor);
 	return newActor;
 }
 
@@ -1092,11 +2006,11 @@ Actor* Map::SpawnPlayerActorAtRandomTileType(Controller* playerController, const
 	spawnInfo.m_actorPosition = chosenTile->GetTilePosition();
 	spawnInfo.m_actorOrientation = EulerAngles(90.f, 0.f, 0.f);
 
-	ActorUID uid = GenerateActorUID(GetTileIndex((int)chosenTile->GetTilePosition().x, (int)chosenTile->GetTilePosition().y));
+	ActorUID uid = GenerateActorUID();
 	Actor* playerActor = new Actor(this, spawnInfo, uid);
 	playerActor->m_owningController = playerController;
 	playerController->m_actorUID = uid;
-	m_actors.emplace_back(playerActor);
+	AddActor(playerActor);
 	
 	return playerActor;
 }
@@ -1135,11 +2049,11 @@ Actor* Map::SpawnPlayerActorAtRandomTileColor(Controller* playerController, cons
 	spawnInfo.m_actorPosition = chosenTile->GetTilePosition();
 	spawnInfo.m_actorOrientation = EulerAngles(90.f, 0.f, 0.f);
 
-	ActorUID uid = GenerateActorUID(GetTileIndex((int)chosenTile->GetTilePosition().x, (int)chosenTile->GetTilePosition().y));
+	ActorUID uid = GenerateActorUID();
 	Actor* playerActor = new Actor(this, spawnInfo, uid);
 	playerActor->m_owningController = playerController;
 	playerController->m_actorUID = uid;
-	m_actors.emplace_back(playerActor);
+	AddActor(playerActor);
 
 	return playerActor;
 }
@@ -1155,19 +2069,24 @@ Controller* Map::GetPlayerController() const
 
 Actor* Map::GetActorByUID(const ActorUID uid) const
 {
-	for (Actor* actor : m_actors)
+	unsigned int slotIndex = uid.GetIndex();
+	if (slotIndex >= m_actorSlots.size())
 	{
-		if (actor && actor->GetUID() == uid)
-		{
-			return actor;
-		}
+		return nullptr;
 	}
-	return nullptr;
+
+	const ActorSlot& slot = m_actorSlots[slotIndex];
+	if (slot.m_denseIndex < 0 || slot.m_generation != uid.GetGeneration())
+	{
+		return nullptr;
+	}
+	return m_actors[slot.m_denseIndex];
 }
 
 void Map::DebugPossessNext()
 {
-	for (int i = m_game->m_player->GetActor()->GetUID().GetIndex() + 1; i < m_actors.size(); i++)
+	int currentIndex = m_actorSlots[m_game->m_player->GetActor()->GetUID().GetIndex()].m_denseIndex;
+	for (int i = currentIndex + 1; i < m_actors.size(); i++)
 	{
 		if (m_actors[i] != nullptr && m_actors[i]->m_canBePossessed)
 		{
@@ -1179,21 +2098,46 @@ void Map::DebugPossessNext()
 
 void Map::DeleteDestroyedActors()
 {
-	for (int i = 0; i < (int)m_actors.size(); i++)
+	for (int i = 0; i < (int)m_actors.size();)
 	{
-		if (m_actors[i] == nullptr)
+		if (!m_actors[i]->m_isDestroyed)
 		{
+			i++;
 			continue;
 		}
 
-		if (m_actors[i]->m_isDestroyed)
+		// Free the slot and move the last actor into the hole, the moved actor is checked next
+		unsigned int slotIndex = m_actors[i]->GetUID().GetIndex();
+		m_actorGrid.RemoveEntry(slotIndex);
+		if (m_actors[i]->m_isItem)
+		{
+			m_triggers.RemoveTrigger(m_actors[i]->m_item->m_triggerIndex);
+			m_actors[i]->m_item->m_triggerIndex = -1;
+		}
+		m_actorSlots[slotIndex].m_denseIndex = -1;
+		m_actorSlots[slotIndex].m_generation++;
+		m_freeActorSlots.push_back(slotIndex);
+		m_retiredActors.push_back(m_actors[i]);
+
+		m_actors[i] = m_actors.back();
+		m_actors.pop_back();
+		m_actorPhysics.RemoveRow(i);
+		if (i < (int)m_actors.size())
 		{
-			delete m_actors[i];
-			m_actors[i] = nullptr;
+			m_actorSlots[m_actors[i]->GetUID().GetIndex()].m_denseIndex = i;
 		}
 	}
 }
 
+void Map::DeleteRetiredActors()
+{
+	for (Actor* actor : m_retiredActors)
+	{
+		delete actor;
+	}
+	m_retiredActors.clear();
+}
+
 void Map::DebugKeys()
 {
 	if (m_game->m_player->m_isShowingDebugOptions)
@@ -1266,6 +2210,14 @@ void Map::AdjustLightCommands()
 
 void Map::MapShutDown()
 {
+	SafeDelete(m_simulationThread);
+
+	for (Job* completedJob : m_deferredCompletedJobs)
+	{
+		HandleCompletedJob(completedJob);
+	}
+	m_deferredCompletedJobs.clear();
+
 	m_tileVertexes.clear();
 	m_tileIndexes.clear();
 
@@ -1281,8 +2233,15 @@ void Map::MapShutDown()
 	s_mapDefinition.clear();
 
 	SafeDelete(m_actors);
+	DeleteRetiredActors();
 
 	m_actors.clear();
+	m_actorSlots.clear();
+	m_freeActorSlots.clear();
+	m_actorGrid.Clear();
+	m_triggers.Clear();
+	m_timers.Clear();
+	m_actorPhysics.Clear();
 	m_matchingEnemyTiles.clear();
 	m_matchingTimerBoxTiles.clear();
 }
@@ -1348,6 +2307,20 @@ MapDefinition::MapDefinition(const tinyxml2::XMLElement* element)
 	m_texture = ParseXmlAttribute(*element, "spriteSheetTexture", std::string());
 	m_cellCount = ParseXmlAttribute(*element, "spriteSheetCellCount", m_cellCount);
 
+	std::string navigation = ParseXmlAttribute(*element, "navigation", std::string("Tile"));
+	if (navigation == "Tile")
+	{
+		m_navigationMode = NavigationMode::TILE;
+	}
+	else if (navigation == "Rect")
+	{
+		m_navigationMode = NavigationMode::RECT;
+	}
+	else
+	{
+		ERROR_AND_DIE(Stringf("Unknown navigation mode \"%s\" in map definition %s", navigation.c_str(), m_name.c_str()));
+	}
+
 	m_mapImage = new Image(m_image.c_str());
 	m_spriteTexture = g_theRenderer->CreateOrGetTextureFromFile(m_texture.c_str());
 }
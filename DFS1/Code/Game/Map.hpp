@@ -1,5 +1,26 @@
 #pragma once
 #include "Game/Tile.hpp"
+#include "Game/PathCache.hpp"
+#include "Game/AStarBatchJob.hpp"
+#include "Game/NavSnapshot.hpp"
+#include "Game/TileVisibilitySet.hpp"
+#include "Game/PerceptionSystem.hpp"
+#include "Game/WallDistanceField.hpp"
+#include "Game/SweptDiscCollision.hpp"
+#include "Game/FrameVisibilityCache.hpp"
+#include "Game/SquadBlackboard.hpp"
+#include "Game/AlertWavefront.hpp"
+#include "Game/InfluenceMap.hpp"
+#include "Game/AILevelOfDetail.hpp"
+#include "Game/PatrolNetwork.hpp"
+#include "Game/ActorSpatialGrid.hpp"
+#include "Game/ActorContactIslands.hpp"
+#include "Game/TriggerSystem.hpp"
+#include "Game/TimerWheel.hpp"
+#include "Game/ActorPhysicsSystem.hpp"
+#include "Game/ActorUpdateJob.hpp"
+#include "Game/RenderSnapshot.hpp"
+#include "Game/TripleBuffer.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Renderer/SpriteDefinition.hpp"
@@ -7,6 +28,7 @@
 #include "Engine/Core/Timer.hpp"
 #include <vector>
 #include <string>
+#include <memory>
 
 class Controller;
 class Game;
@@ -17,6 +39,10 @@ class Texture;
 class Image;
 class VertexBuffer;
 class IndexBuffer;
+class RandomNumberGenerator;
+class AIActor;
+class Job;
+class SimulationThread;
 
 struct RaycastResult
 {
@@ -43,6 +69,14 @@ struct SpawnInfo
 	EulerAngles m_actorOrientation;
 };
 
+// Handle table entry for one ActorUID index. The generation is bumped every time the slot is freed, so
+// handles to an actor that has been deleted stop matching even once the slot is reused
+struct ActorSlot
+{
+	int m_denseIndex = -1; // Where the actor sits in Map::m_actors, -1 while the slot is free
+	unsigned int m_generation = 0;
+};
+
 struct MapDefinition
 {
 	MapDefinition() {}
@@ -55,6 +89,7 @@ struct MapDefinition
 	Image* m_mapImage = nullptr;
 	Texture* m_spriteTexture = nullptr;
 	IntVec2 m_cellCount = IntVec2::ZERO;
+	NavigationMode m_navigationMode = NavigationMode::TILE;
 
 	static void InitializeMapDef();
 	static MapDefinition* GetMapDefByName(const std::string& name);
@@ -75,6 +110,9 @@ public:
 	~Map();
 	Map(Game* owner, MapDefinition definition);
 	void InitializeMap();
+	void PublishNavSnapshot();
+	void BuildTileVisibility();
+	void BuildPatrolNetwork();
 	void AddVertsForTile(int tileIndex, const SpriteSheet& spriteSheet);
 	IntVec2 GetMapDimensions();
 	Vec3 GetMapWorldCenterPosition();
@@ -84,8 +122,9 @@ public:
 	const Tile* GetTile(int x, int y) const;
 	int GetTileIndex(int x, int y) const;
 	IntVec2 GetTileCoordsForPos(const Vec3& position);
-	IntVec2 GetRandomTilewithinRange(const IntVec2& startPos, int range) const;
+	IntVec2 GetRandomTilewithinRange(const IntVec2& startPos, int range, RandomNumberGenerator& rng) const;
 	bool IsSolidTile(int tileX, int tileY) const;
+	void SetTileDefinition(const IntVec2& tileCoords, const TileDefinition* tileDef);
 	bool AreAdjacentTileNonSolid(int currentTileX, int currentTileY, int neighborX, int neighborY) const;
 	bool AreAdjacentTileNonSolid(const IntVec2& currentTilePos, const IntVec2& neighborCoords) const;
 	bool AreActorsCloseEnough(const Actor& actor1, const Actor& actor2, float distanceThreshold);
@@ -96,17 +135,44 @@ public:
 
 	void CreateSky();
 	void CreateBuffers();
+	void CreateTileBuffers();
+	void RebuildTileBuffers();
 	void MapRender();
 	void RenderSkyBox() const;
 	void RenderActors();
 	void MapUpdate();
+	void RunSimulationFrame(float frameDeltaSeconds);
+	void WaitForSimulation();
+	void UpdateSimulationStep();
+	void SavePreviousTransforms();
+	float GetStepDeltaSeconds() const;
+	void PublishRenderSnapshot();
+	void AcquireRenderSnapshot();
+	void AddDebugOverlayLines(RenderSnapshot& snapshot);
+	RenderSnapshot& GetBuildingSnapshot();
+	const RenderSnapshot& GetRenderSnapshot() const;
 	void UpdateGameLogic();
+	void UpdatePerception();
+	void UpdateSquadAlerts();
+	void UpdateInfluenceMap();
+	void UpdateAILevelOfDetail();
 	void UpdateActors();
+	void UpdateActorPhysics();
+	int RunActorUpdatePhase(ActorUpdatePhase phase, int numItems);
+	void QueueBatchedPathfindingJobs();
+	void RetrieveCompletedPathfindingJobs();
+	void HandleCompletedJob(Job* completedJob);
+	void DeliverPath(const ActorUID& aiUID, const IntVec2* waypoints, size_t numWaypoints);
 
 	void GetMaxNumberSpawnedEnemyActors();
 	Actor* GetItemActor();
 	Actor* GetPlayerActor();
-	ActorUID GenerateActorUID(int actorIndex);
+	ActorUID GenerateActorUID();
+	void AddActor(Actor* actor);
+	Actor* GetActorInSlot(unsigned int slotIndex) const;
+	int GetActorRow(const ActorUID& uid) const;
+	void UpdateActorInGrid(const Actor* actor);
+	bool IsActorAtPosition(const Vec3& position);
 	Actor* SpawnActor(const SpawnInfo& spawnInfo);
 	Actor* SpawnPlayerActorAtRandomTileType(Controller* playerController, const std::string& tileTypeName);
 	Actor* SpawnPlayerActorAtRandomTileColor(Controller* playerController, const Rgba8& tileColor);
@@ -115,15 +181,23 @@ public:
 	Controller* GetPlayerController() const;
 	void DebugPossessNext();
 	void DeleteDestroyedActors();
+	void DeleteRetiredActors();
 
 	void CollideActors();
+	void GatherActorContacts();
+	void ResolveContactIsland(int islandIndex);
 	void CollideActors(Actor* actorA, Actor* actorB);
+	void ValidateContactIslands(std::vector<std::string>& outLines);
 	void CollideActorsWithMap();
+	void SweepActorsAgainstWalls();
+	void UpdateTriggers();
 	bool PushActorOutOfWalls(Actor* actor, const AABB2& tileBounds) const;
 
 	float GetAngleToActor(Actor* referenceActor, Actor* targetActor);
 	RaycastResult RaycastAll(Actor* actor, const Vec3& start, const Vec3& direction, float distance) const; 
 	RaycastResult RaycastWorldXY(const Vec3& start, const Vec3& direction, float distance) const; 
+	RaycastResult RaycastWorldXYWallDistanceSkip(const Vec3& start, const Vec3& direction, float distance) const; // Measured against RaycastWorldXY by ValidateWallRaycasts, not used in game
+	void ValidateWallDistanceRaycasts(int numRays, std::vector<std::string>& outLines) const;
 	RaycastResult RaycastWorldActors(Actor* actor, const Vec3& start, const Vec3& direction, float distance) const; 
 
 	void DebugKeys();
@@ -137,6 +211,49 @@ public:
 	std::vector<Vertex_PCUTBN> m_tileVertexes;
 	std::vector<unsigned int> m_tileIndexes;
 	std::vector<int> m_controllerList;
+	std::shared_ptr<PathCache> m_pathCache;
+	std::vector<PathRequest> m_pendingPathRequests;
+	bool m_isBatchingPathRequests = true;
+	bool m_isSmoothingPaths = true;
+	std::shared_ptr<const NavSnapshot> m_navSnapshot;
+	unsigned int m_navVersion = 0;
+	TileVisibilitySet m_tileVisibility;
+	WallDistanceField m_wallDistance;
+	float m_lastVisibilityBuildMS = 0.f;
+	PerceptionSystem m_perception;
+	FrameVisibilityCache m_visibilityCache;
+	SquadBlackboard m_squadBlackboard;
+	AlertWavefront m_alertWavefront;
+	InfluenceMap m_influenceMap;
+	AILevelOfDetail m_aiLevelOfDetail;
+	PatrolNetwork m_patrolNetwork;
+	bool m_isUsingPatrolNetwork = true;
+	bool m_isBatchingPerception = true;
+	unsigned int m_mapID = 0;
+	static unsigned int s_nextMapID;
+	int m_lastBatchNumRequests = 0;
+	int m_lastBatchNumJobs = 0;
+	bool m_isUpdatingActorsInParallel = true;
+	bool m_isThinkingAIsInPhases = false; // Set per frame, AI controllers are then skipped by Actor::Update
+	int m_minActorsPerUpdateJob = 64;
+	std::vector<AIActor*> m_thinkingAIs;
+	std::vector<Job*> m_deferredCompletedJobs;
+	int m_lastThinkNumJobs = 0;
+	int m_lastIntegrateNumJobs = 0;
+	float m_lastThinkMS = 0.f;
+	bool m_isUsingFixedStep = true;
+	float m_fixedStepSeconds = 1.f / 60.f;
+	int m_maxStepsPerFrame = 5;
+	float m_stepAccumulatorSeconds = 0.f;
+	float m_stepDeltaSeconds = 0.f; // What the simulation reads instead of the clock's frame delta
+	float m_stepInterpolation = 1.f; // How far rendering is between the last two steps
+	int m_numStepsLastFrame = 0;
+	bool m_isUsingSimulationThread = true;
+	bool m_isSweepingWallCollision = true; // Trace each step's move against the walls instead of only pushing out afterwards
+	SimulationThread* m_simulationThread = nullptr;
+	TripleBuffer<RenderSnapshot> m_renderSnapshots;
+	float m_lastSimulationFrameMS = 0.f;
+	float m_lastSimulationWaitMS = 0.f; // How long the main thread sat waiting for the simulation after rendering
 
 public:
 	Vec3 m_sunDirection = Vec3::ZERO;
@@ -152,21 +269,31 @@ public:
 	std::vector<Vertex_PCU> m_skyVertices;
 
 public:
-	std::vector<Actor*> m_actors;
+	std::vector<Actor*> m_actors; // Live actors only, packed; look actors up through their ActorUID
 	std::vector<Actor*> m_aiActors;
+	std::vector<Actor*> m_retiredActors; // Destroyed but possibly still drawn from the current snapshot
 	std::vector<Tile*> m_matchingEnemyTiles;
 	std::vector<Tile*> m_matchingTimerBoxTiles;
 	std::vector<Actor*> m_numEnemyActors;
 	int m_maxNumEnemies = 200;
 	int m_maxNumTimerBoxes = 100;
-	static const unsigned int MAX_ACTOR_SALT = 0x0000fffeu;
-	unsigned int m_actorSalt = MAX_ACTOR_SALT;
+	std::vector<ActorSlot> m_actorSlots;
+	std::vector<unsigned int> m_freeActorSlots;
+	ActorSpatialGrid m_actorGrid;
+	ActorPhysicsSystem m_actorPhysics; // Rows follow m_actors
+	std::vector<std::pair<unsigned int, unsigned int>> m_actorPairs;
+	ActorContactIslands m_contactIslands;
+	int m_actorCollisionIterations = 1;
+	int m_lastCollideNumJobs = 0;
+	TriggerSystem m_triggers; // Item pickups, kept out of the actor grid
+	std::vector<TriggerHit> m_triggerHits;
+	TimerWheel m_timers; // Gameplay timers, advanced once per simulation step
+	std::vector<unsigned int> m_actorQueryResults;
 public:
 	bool m_canSeeAiPath = false;
 	bool m_canSeeAiGoalPosition = false;
 public:
 	float m_gameTime = 45.f;
-	float m_addTimeShow = 1.f;
 	bool m_didAddTime = false;
 	bool m_hasPlayerReachedGoal = false;
 };
\ No newline at end of file
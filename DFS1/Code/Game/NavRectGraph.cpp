@@ -0,0 +1,233 @@
+#include "Game/NavRectGraph.hpp"
+#include <queue>
+#include <cmath>
+#include <algorithm>
+
+void NavRectGraph::Build(const IntVec2& dimensions, const std::function<bool(int, int)>& isSolid)
+{
+	m_dimensions = dimensions;
+	m_rects.clear();
+	m_links.clear();
+	m_rectIndexForTile.assign(dimensions.x * dimensions.y, -1);
+
+	// Greedy maximal rectangles: grow each unclaimed walkable tile right as far as possible, then up while the whole row is free
+	for (int tileY = 0; tileY < dimensions.y; tileY++)
+	{
+		for (int tileX = 0; tileX < dimensions.x; tileX++)
+		{
+			int tileIndex = tileX + tileY * dimensions.x;
+			if (m_rectIndexForTile[tileIndex] >= 0 || isSolid(tileX, tileY))
+			{
+				continue;
+			}
+
+			int maxX = tileX;
+			while (maxX + 1 < dimensions.x && m_rectIndexForTile[maxX + 1 + tileY * dimensions.x] < 0 && !isSolid(maxX + 1, tileY))
+			{
+				maxX++;
+			}
+
+			int maxY = tileY;
+			bool canGrow = true;
+			while (canGrow && maxY + 1 < dimensions.y)
+			{
+				for (int rowX = tileX; rowX <= maxX; rowX++)
+				{
+					if (m_rectIndexForTile[rowX + (maxY + 1) * dimensions.x] >= 0 || isSolid(rowX, maxY + 1))
+					{
+						canGrow = false;
+						break;
+					}
+				}
+				if (canGrow)
+				{
+					maxY++;
+				}
+			}
+
+			NavRect newRect;
+			newRect.m_mins = IntVec2(tileX, tileY);
+			newRect.m_maxs = IntVec2(maxX, maxY);
+			int rectIndex = static_cast<int>(m_rects.size());
+			m_rects.push_back(newRect);
+
+			for (int rectY = tileY; rectY <= maxY; rectY++)
+			{
+				for (int rectX = tileX; rectX <= maxX; rectX++)
+				{
+					m_rectIndexForTile[rectX + rectY * dimensions.x] = rectIndex;
+				}
+			}
+		}
+	}
+
+	for (int rectIndex = 0; rectIndex < static_cast<int>(m_rects.size()); rectIndex++)
+	{
+		NavRect& rect = m_rects[rectIndex];
+		int width = rect.m_maxs.x - rect.m_mins.x + 1;
+		int height = rect.m_maxs.y - rect.m_mins.y + 1;
+		rect.m_firstLink = static_cast<int>(m_links.size());
+
+		AddLinksAlongSide(rectIndex, IntVec2(rect.m_mins.x, rect.m_mins.y), IntVec2(1, 0), width, IntVec2(0, -1));
+		AddLinksAlongSide(rectIndex, IntVec2(rect.m_mins.x, rect.m_maxs.y), IntVec2(1, 0), width, IntVec2(0, 1));
+		AddLinksAlongSide(rectIndex, IntVec2(rect.m_mins.x, rect.m_mins.y), IntVec2(0, 1), height, IntVec2(-1, 0));
+		AddLinksAlongSide(rectIndex, IntVec2(rect.m_maxs.x, rect.m_mins.y), IntVec2(0, 1), height, IntVec2(1, 0));
+
+		m_rects[rectIndex].m_numLinks = static_cast<int>(m_links.size()) - m_rects[rectIndex].m_firstLink;
+	}
+}
+
+void NavRectGraph::AddLinksAlongSide(int rectIndex, const IntVec2& firstTile, const IntVec2& alongStep, int sideLength, const IntVec2& crossingStep)
+{
+	// Neighbors are rectangles too, so each one shares a single contiguous run of tiles with this side
+	int currentNeighbor = -1;
+	for (int step = 0; step < sideLength; step++)
+	{
+		IntVec2 tileCoords = firstTile + IntVec2(alongStep.x * step, alongStep.y * step);
+		int neighborIndex = GetRectIndexForTile(tileCoords + crossingStep);
+		if (neighborIndex < 0 || neighborIndex == rectIndex)
+		{
+			currentNeighbor = -1;
+			continue;
+		}
+
+		if (neighborIndex == currentNeighbor)
+		{
+			m_links.back().m_portalMaxs = tileCoords;
+			continue;
+		}
+
+		NavRectLink newLink;
+		newLink.m_neighborIndex = neighborIndex;
+		newLink.m_portalMins = tileCoords;
+		newLink.m_portalMaxs = tileCoords;
+		newLink.m_crossingStep = crossingStep;
+		m_links.push_back(newLink);
+		currentNeighbor = neighborIndex;
+	}
+}
+
+bool NavRectGraph::FindPath(const IntVec2& start, const IntVec2& goal, std::vector<IntVec2>& outPath) const
+{
+	outPath.clear();
+
+	int startRect = GetRectIndexForTile(start);
+	int goalRect = GetRectIndexForTile(goal);
+	if (startRect < 0 || goalRect < 0)
+	{
+		return false;
+	}
+
+	if (startRect == goalRect)
+	{
+		// Rectangles are fully walkable so the goal can be reached in a straight line
+		if (start != goal)
+		{
+			outPath.push_back(goal);
+		}
+		return true;
+	}
+
+	// Each rectangle is entered on a single tile, costs are measured between those entry tiles
+	int numRects = static_cast<int>(m_rects.size());
+	std::vector<float> costSoFar(numRects, -1.f);
+	std::vector<int> cameFromLink(numRects, -1);
+	std::vector<IntVec2> entryTile(numRects, IntVec2::ZERO);
+	std::vector<bool> isClosed(numRects, false);
+
+	auto GetDistance = [](const IntVec2& a, const IntVec2& b)
+		{
+			float deltaX = static_cast<float>(a.x - b.x);
+			float deltaY = static_cast<float>(a.y - b.y);
+			return sqrtf(deltaX * deltaX + deltaY * deltaY);
+		};
+
+	typedef std::pair<float, int> OpenEntry;
+	std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> openSet;
+
+	costSoFar[startRect] = 0.f;
+	entryTile[startRect] = start;
+	openSet.push(OpenEntry(GetDistance(start, goal), startRect));
+
+	while (!openSet.empty())
+	{
+		int currentRect = openSet.top().second;
+		openSet.pop();
+		if (isClosed[currentRect])
+		{
+			continue;
+		}
+		isClosed[currentRect] = true;
+
+		if (currentRect == goalRect)
+		{
+			break;
+		}
+
+		const NavRect& rect = m_rects[currentRect];
+		for (int linkIndex = rect.m_firstLink; linkIndex < rect.m_firstLink + rect.m_numLinks; linkIndex++)
+		{
+			const NavRectLink& link = m_links[linkIndex];
+			if (isClosed[link.m_neighborIndex])
+			{
+				continue;
+			}
+
+			// Cross at the portal tile nearest to where this rectangle was entered
+			const IntVec2& entry = entryTile[currentRect];
+			IntVec2 portalTile = IntVec2(std::clamp(entry.x, link.m_portalMins.x, link.m_portalMaxs.x), std::clamp(entry.y, link.m_portalMins.y, link.m_portalMaxs.y));
+			IntVec2 neighborEntry = portalTile + link.m_crossingStep;
+			float newCost = costSoFar[currentRect] + GetDistance(entry, portalTile) + 1.f;
+
+			if (costSoFar[link.m_neighborIndex] < 0.f || newCost < costSoFar[link.m_neighborIndex])
+			{
+				costSoFar[link.m_neighborIndex] = newCost;
+				cameFromLink[link.m_neighborIndex] = linkIndex;
+				entryTile[link.m_neighborIndex] = neighborEntry;
+				openSet.push(OpenEntry(newCost + GetDistance(neighborEntry, goal), link.m_neighborIndex));
+			}
+		}
+	}
+
+	if (!isClosed[goalRect])
+	{
+		return false;
+	}
+
+	// Walk back from the goal, matching the GridAStar layout of goal first and next step last
+	outPath.push_back(goal);
+	for (int currentRect = goalRect; currentRect != startRect;)
+	{
+		const NavRectLink& link = m_links[cameFromLink[currentRect]];
+		IntVec2 neighborEntry = entryTile[currentRect];
+		IntVec2 portalTile = neighborEntry - link.m_crossingStep;
+		if (outPath.back() != neighborEntry)
+		{
+			outPath.push_back(neighborEntry);
+		}
+		outPath.push_back(portalTile);
+
+		// The portal tile sits in the rectangle the link leaves from
+		currentRect = GetRectIndexForTile(portalTile);
+	}
+
+	if (!outPath.empty() && outPath.back() == start)
+	{
+		outPath.pop_back();
+	}
+	return true;
+}
+
+int NavRectGraph::GetRectIndexForTile(const IntVec2& tileCoords) const
+{
+	if (tileCoords.x < 0 || tileCoords.y < 0 || tileCoords.x >= m_dimensions.x || tileCoords.y >= m_dimensions.y)
+	{
+		return -1;
+	}
+	return m_rectIndexForTile[tileCoords.x + tileCoords.y * m_dimensions.x];
+}
+
+int NavRectGraph::GetNumRects() const
+{
+	return static_cast<int>(m_rects.size());
+}
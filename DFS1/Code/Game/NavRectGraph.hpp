@@ -0,0 +1,53 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include <vector>
+#include <functional>
+
+enum class NavigationMode
+{
+	TILE,
+	RECT
+};
+
+// Walkable area split into axis-aligned rectangles, bounds are inclusive tile coords
+struct NavRect
+{
+	IntVec2 m_mins = IntVec2::ZERO;
+	IntVec2 m_maxs = IntVec2::ZERO;
+	int m_firstLink = 0;
+	int m_numLinks = 0;
+};
+
+// Shared edge between two rectangles. The portal is the run of tiles along this rectangle's side of
+// the edge, stepping by m_crossingStep from any of them lands in the neighbor
+struct NavRectLink
+{
+	int m_neighborIndex = -1;
+	IntVec2 m_portalMins = IntVec2::ZERO;
+	IntVec2 m_portalMaxs = IntVec2::ZERO;
+	IntVec2 m_crossingStep = IntVec2::ZERO;
+};
+
+// Coarse navigation graph for open areas. Searches run over rectangles instead of tiles and are only
+// refined to tile waypoints (the portal crossings) once the rectangle route is known
+class NavRectGraph
+{
+public:
+	NavRectGraph() = default;
+	~NavRectGraph() = default;
+
+	void Build(const IntVec2& dimensions, const std::function<bool(int, int)>& isSolid);
+	bool FindPath(const IntVec2& start, const IntVec2& goal, std::vector<IntVec2>& outPath) const;
+
+	int GetRectIndexForTile(const IntVec2& tileCoords) const;
+	int GetNumRects() const;
+
+private:
+	void AddLinksAlongSide(int rectIndex, const IntVec2& firstTile, const IntVec2& alongStep, int sideLength, const IntVec2& crossingStep);
+
+public:
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	std::vector<NavRect> m_rects;
+	std::vector<NavRectLink> m_links;
+	std::vector<int> m_rectIndexForTile;
+};
@@ -0,0 +1,327 @@
+#include "Game/NavSnapshot.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+NavSnapshot::NavSnapshot(unsigned int mapID, unsigned int version, const IntVec2& dimensions, std::vector<unsigned char>&& solidTiles, bool useRectGraph)
+	:m_mapID(mapID), m_version(version), m_dimensions(dimensions), m_solidTiles(std::move(solidTiles))
+{
+	if (useRectGraph)
+	{
+		m_rectGraph = std::make_unique<NavRectGraph>();
+		m_rectGraph->Build(m_dimensions, [this](int tileX, int tileY) { return IsSolidTile(tileX, tileY); });
+	}
+}
+
+bool NavSnapshot::IsSolidTile(int tileX, int tileY) const
+{
+	// Matches Map::IsSolidTile, out of bounds tiles are not solid
+	if (tileX < 0 || tileY < 0 || tileX >= m_dimensions.x || tileY >= m_dimensions.y)
+	{
+		return false;
+	}
+	return m_solidTiles[tileX + tileY * m_dimensions.x] != 0;
+}
+
+bool NavSnapshot::IsLineOfTravelClear(const Vec2& start, const Vec2& end, float radius) const
+{
+	// Walks the segment one tile row at a time, checking every tile the segment touches once it is
+	// widened by the radius on both axes. Treating the disc as a square keeps this conservative
+	float minY = std::min(start.y, end.y);
+	float maxY = std::max(start.y, end.y);
+	float deltaX = end.x - start.x;
+	float deltaY = end.y - start.y;
+
+	int firstRow = RoundDownToInt(minY - radius);
+	int lastRow = RoundDownToInt(maxY + radius);
+	for (int tileY = firstRow; tileY <= lastRow; tileY++)
+	{
+		float rowMinY = std::max(minY, static_cast<float>(tileY) - radius);
+		float rowMaxY = std::min(maxY, static_cast<float>(tileY + 1) + radius);
+
+		float rowMinX = std::min(start.x, end.x);
+		float rowMaxX = std::max(start.x, end.x);
+		if (fabsf(deltaY) > 0.0001f)
+		{
+			float xAtRowMinY = start.x + deltaX * ((rowMinY - start.y) / deltaY);
+			float xAtRowMaxY = start.x + deltaX * ((rowMaxY - start.y) / deltaY);
+			rowMinX = std::min(xAtRowMinY, xAtRowMaxY);
+			rowMaxX = std::max(xAtRowMinY, xAtRowMaxY);
+		}
+
+		int firstColumn = RoundDownToInt(rowMinX - radius);
+		int lastColumn = RoundDownToInt(rowMaxX + radius);
+		for (int tileX = firstColumn; tileX <= lastColumn; tileX++)
+		{
+			if (IsSolidTile(tileX, tileY))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void NavSnapshot::SmoothPath(const IntVec2& start, std::vector<IntVec2>& path, float radius) const
+{
+	if (path.size() < 2)
+	{
+		return;
+	}
+
+	// String pulling in travel order (back to front). A waypoint is dropped when the last kept point can
+	// see the one after it. Kept waypoints are compacted toward the back so no extra storage is needed
+	int lastIndex = static_cast<int>(path.size()) - 1;
+	int writeIndex = lastIndex;
+	IntVec2 anchor = start;
+	for (int readIndex = lastIndex; readIndex >= 1; readIndex--)
+	{
+		Vec2 anchorCenter = Vec2(static_cast<float>(anchor.x) + 0.5f, static_cast<float>(anchor.y) + 0.5f);
+		Vec2 nextCenter = Vec2(static_cast<float>(path[readIndex - 1].x) + 0.5f, static_cast<float>(path[readIndex - 1].y) + 0.5f);
+		if (!IsLineOfTravelClear(anchorCenter, nextCenter, radius))
+		{
+			anchor = path[readIndex];
+			path[writeIndex--] = anchor;
+		}
+	}
+	path[writeIndex] = path[0];
+	path.erase(path.begin(), path.begin() + writeIndex);
+}
+
+void NavSnapshot::ConfigureGridAStar(GridAStar& pathfinder) const
+{
+	pathfinder.SetIsSolidCallback([this](IntVec2 coords) { return IsSolidTile(coords.x, coords.y); });
+	pathfinder.SetCanMoveDiagonalCallback([this](IntVec2 from, IntVec2 to)
+		{
+			IntVec2 direction = to - from;
+			if (direction.x != 0 && direction.y != 0)
+			{
+				IntVec2 adjacent1 = from + IntVec2(direction.x, 0);
+				IntVec2 adjacent2 = from + IntVec2(0, direction.y);
+				return !IsSolidTile(adjacent1.x, adjacent1.y) && !IsSolidTile(adjacent2.x, adjacent2.y);
+			}
+			return true; // Its not a valid move to go diagonal
+		});
+}
+
+void NavSnapshot::ComputePath(const IntVec2& start, const IntVec2& goal, DirectionMode directionMode, std::vector<IntVec2>& outPath) const
+{
+	if (GetNavigationMode(directionMode) == NavigationMode::RECT)
+	{
+		m_rectGraph->FindPath(start, goal, outPath);
+		return;
+	}
+
+	GridAStar pathfinder(m_dimensions);
+	pathfinder.SetDirectionMode(directionMode);
+	ConfigureGridAStar(pathfinder);
+	pathfinder.ComputeAStar(start, goal, outPath);
+}
+
+unsigned int NavSnapshot::GetMapID() const
+{
+	return m_mapID;
+}
+
+unsigned int NavSnapshot::GetVersion() const
+{
+	return m_version;
+}
+
+IntVec2 NavSnapshot::GetDimensions() const
+{
+	return m_dimensions;
+}
+
+const NavRectGraph* NavSnapshot::GetRectGraph() const
+{
+	return m_rectGraph.get();
+}
+
+NavigationMode NavSnapshot::GetNavigationMode(DirectionMode directionMode) const
+{
+	// Rect routes cut straight across rectangles at any angle, so they only stand in for eight way searches
+	if (m_rectGraph && directionMode == DirectionMode::Cardinal8)
+	{
+		return NavigationMode::RECT;
+	}
+	return NavigationMode::TILE;
+}
+
+const std::vector<unsigned char>& NavSnapshot::GetSolidTiles() const
+{
+	return m_solidTiles;
+}
+
+int NavSnapshot::ComputePathToNearestGoal(const IntVec2& start, const std::vector<IntVec2>& goals, DirectionMode directionMode, NearestGoalScratch& scratch, std::vector<IntVec2>& outPath) const
+{
+	// One search for any number of goals: the heuristic is the distance to the closest goal, which never
+	// overestimates. With many goals that costs more per tile than it saves so it drops to plain Dijkstra,
+	// which still stops at the first goal it settles. Always searches tiles, even on rect graph maps
+	outPath.clear();
+	if (start.x < 0 || start.y < 0 || start.x >= m_dimensions.x || start.y >= m_dimensions.y)
+	{
+		return -1;
+	}
+
+	const int MAX_HEURISTIC_GOALS = 8;
+	const float DIAGONAL_COST = 1.41421356f;
+	int numTiles = m_dimensions.x * m_dimensions.y;
+	bool canMoveDiagonally = directionMode == DirectionMode::Cardinal8;
+
+	if (static_cast<int>(scratch.m_tileSerials.size()) != numTiles)
+	{
+		scratch.m_tileSerials.assign(numTiles, 0);
+		scratch.m_goalAtTile.resize(numTiles);
+		scratch.m_costSoFar.resize(numTiles);
+		scratch.m_cameFrom.resize(numTiles);
+		scratch.m_isClosed.resize(numTiles);
+		scratch.m_searchSerial = 0;
+	}
+	scratch.m_searchSerial++;
+	if (scratch.m_searchSerial == 0)
+	{
+		std::fill(scratch.m_tileSerials.begin(), scratch.m_tileSerials.end(), 0);
+		scratch.m_searchSerial = 1;
+	}
+
+	std::vector<int>& goalAtTile = scratch.m_goalAtTile;
+	std::vector<float>& costSoFar = scratch.m_costSoFar;
+	std::vector<int>& cameFrom = scratch.m_cameFrom;
+	std::vector<unsigned char>& isClosed = scratch.m_isClosed;
+	auto TouchTile = [&](int tileIndex)
+		{
+			if (scratch.m_tileSerials[tileIndex] != scratch.m_searchSerial)
+			{
+				scratch.m_tileSerials[tileIndex] = scratch.m_searchSerial;
+				goalAtTile[tileIndex] = -1;
+				costSoFar[tileIndex] = -1.f;
+				cameFrom[tileIndex] = -1;
+				isClosed[tileIndex] = 0;
+			}
+		};
+
+	std::vector<IntVec2>& heuristicGoals = scratch.m_heuristicGoals;
+	heuristicGoals.clear();
+	for (int goalIndex = 0; goalIndex < static_cast<int>(goals.size()); goalIndex++)
+	{
+		const IntVec2& goal = goals[goalIndex];
+		if (goal.x < 0 || goal.y < 0 || goal.x >= m_dimensions.x || goal.y >= m_dimensions.y || IsSolidTile(goal.x, goal.y))
+		{
+			continue;
+		}
+		int goalTile = goal.x + goal.y * m_dimensions.x;
+		TouchTile(goalTile);
+		if (goalAtTile[goalTile] < 0)
+		{
+			goalAtTile[goalTile] = goalIndex;
+			heuristicGoals.push_back(goal);
+		}
+	}
+	if (heuristicGoals.empty())
+	{
+		return -1;
+	}
+	if (static_cast<int>(heuristicGoals.size()) > MAX_HEURISTIC_GOALS)
+	{
+		heuristicGoals.clear();
+	}
+
+	auto GetHeuristic = [&](int tileX, int tileY)
+		{
+			float nearest = 0.f;
+			for (int goalIndex = 0; goalIndex < static_cast<int>(heuristicGoals.size()); goalIndex++)
+			{
+				int deltaX = abs(heuristicGoals[goalIndex].x - tileX);
+				int deltaY = abs(heuristicGoals[goalIndex].y - tileY);
+				float distance = canMoveDiagonally ? static_cast<float>(std::max(deltaX, deltaY)) + (DIAGONAL_COST - 1.f) * static_cast<float>(std::min(deltaX, deltaY)) : static_cast<float>(deltaX + deltaY);
+				if (goalIndex == 0 || distance < nearest)
+				{
+					nearest = distance;
+				}
+			}
+			return nearest;
+		};
+
+	// Min heap on the scratch vector, so its storage is kept between searches
+	typedef std::pair<float, int> OpenEntry;
+	std::vector<OpenEntry>& openSet = scratch.m_openSet;
+	openSet.clear();
+	std::greater<OpenEntry> isWorseEntry;
+
+	int startTile = start.x + start.y * m_dimensions.x;
+	TouchTile(startTile);
+	costSoFar[startTile] = 0.f;
+	openSet.push_back(OpenEntry(GetHeuristic(start.x, start.y), startTile));
+
+	const IntVec2 neighborOffsets[8] = { IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1), IntVec2(1, 1), IntVec2(-1, 1), IntVec2(1, -1), IntVec2(-1, -1) };
+	int numNeighborOffsets = canMoveDiagonally ? 8 : 4;
+	int reachedTile = -1;
+	while (!openSet.empty())
+	{
+		std::pop_heap(openSet.begin(), openSet.end(), isWorseEntry);
+		int currentTile = openSet.back().second;
+		openSet.pop_back();
+		if (isClosed[currentTile])
+		{
+			continue;
+		}
+		isClosed[currentTile] = 1;
+
+		if (goalAtTile[currentTile] >= 0)
+		{
+			reachedTile = currentTile;
+			break;
+		}
+
+		int currentX = currentTile % m_dimensions.x;
+		int currentY = currentTile / m_dimensions.x;
+		for (int offsetIndex = 0; offsetIndex < numNeighborOffsets; offsetIndex++)
+		{
+			const IntVec2& offset = neighborOffsets[offsetIndex];
+			int neighborX = currentX + offset.x;
+			int neighborY = currentY + offset.y;
+			if (neighborX < 0 || neighborY < 0 || neighborX >= m_dimensions.x || neighborY >= m_dimensions.y || IsSolidTile(neighborX, neighborY))
+			{
+				continue;
+			}
+
+			// Same corner rule as ConfigureGridAStar, a diagonal step needs both tiles beside it open
+			bool isDiagonal = offset.x != 0 && offset.y != 0;
+			if (isDiagonal && (IsSolidTile(currentX + offset.x, currentY) || IsSolidTile(currentX, currentY + offset.y)))
+			{
+				continue;
+			}
+
+			int neighborTile = neighborX + neighborY * m_dimensions.x;
+			TouchTile(neighborTile);
+			if (isClosed[neighborTile])
+			{
+				continue;
+			}
+
+			float newCost = costSoFar[currentTile] + (isDiagonal ? DIAGONAL_COST : 1.f);
+			if (costSoFar[neighborTile] < 0.f || newCost < costSoFar[neighborTile])
+			{
+				costSoFar[neighborTile] = newCost;
+				cameFrom[neighborTile] = currentTile;
+				openSet.push_back(OpenEntry(newCost + GetHeuristic(neighborX, neighborY), neighborTile));
+				std::push_heap(openSet.begin(), openSet.end(), isWorseEntry);
+			}
+		}
+	}
+
+	if (reachedTile < 0)
+	{
+		return -1;
+	}
+
+	// Goal first and next step last, the same layout ComputePath hands back
+	for (int currentTile = reachedTile; currentTile != startTile; currentTile = cameFrom[currentTile])
+	{
+		outPath.push_back(IntVec2(currentTile % m_dimensions.x, currentTile / m_dimensions.x));
+	}
+	return goalAtTile[reachedTile];
+}
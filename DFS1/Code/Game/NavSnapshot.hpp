@@ -0,0 +1,54 @@
+#pragma once
+#include "Game/NavRectGraph.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/AI/Pathfinding/Grid/GridAStar.hpp"
+#include <vector>
+#include <memory>
+#include <utility>
+
+// Working buffers for NavSnapshot::ComputePathToNearestGoal. A path job keeps one for all of its requests,
+// the same way it keeps one GridAStar, so the map sized arrays are only allocated once per job. Tiles carry
+// the serial of the search that last touched them instead of being cleared between searches
+struct NearestGoalScratch
+{
+	unsigned int m_searchSerial = 0;
+	std::vector<unsigned int> m_tileSerials;
+	std::vector<int> m_goalAtTile;
+	std::vector<float> m_costSoFar;
+	std::vector<int> m_cameFrom;
+	std::vector<unsigned char> m_isClosed;
+	std::vector<std::pair<float, int>> m_openSet;
+	std::vector<IntVec2> m_heuristicGoals;
+};
+
+// Read-only copy of a map's walkability, handed to path jobs by shared_ptr. A new snapshot is published
+// whenever tile solidity changes, jobs keep whichever version they were queued with alive until they finish
+class NavSnapshot
+{
+public:
+	NavSnapshot(unsigned int mapID, unsigned int version, const IntVec2& dimensions, std::vector<unsigned char>&& solidTiles, bool useRectGraph);
+	~NavSnapshot() = default;
+
+	bool IsSolidTile(int tileX, int tileY) const;
+	bool IsLineOfTravelClear(const Vec2& start, const Vec2& end, float radius) const;
+	void SmoothPath(const IntVec2& start, std::vector<IntVec2>& path, float radius) const;
+
+	void ConfigureGridAStar(GridAStar& pathfinder) const;
+	void ComputePath(const IntVec2& start, const IntVec2& goal, DirectionMode directionMode, std::vector<IntVec2>& outPath) const;
+	int ComputePathToNearestGoal(const IntVec2& start, const std::vector<IntVec2>& goals, DirectionMode directionMode, NearestGoalScratch& scratch, std::vector<IntVec2>& outPath) const;
+
+	unsigned int GetMapID() const;
+	unsigned int GetVersion() const;
+	IntVec2 GetDimensions() const;
+	const NavRectGraph* GetRectGraph() const;
+	NavigationMode GetNavigationMode(DirectionMode directionMode) const;
+	const std::vector<unsigned char>& GetSolidTiles() const;
+
+private:
+	unsigned int m_mapID = 0;
+	unsigned int m_version = 0;
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	std::vector<unsigned char> m_solidTiles;
+	std::unique_ptr<NavRectGraph> m_rectGraph;
+};
@@ -0,0 +1,276 @@
+#include "Game/PathCache.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include <mutex>
+#include <algorithm>
+
+bool PathCacheKey::operator==(const PathCacheKey& other) const
+{
+	return m_start == other.m_start && m_goal == other.m_goal && m_directionMode == other.m_directionMode && m_navigationMode == other.m_navigationMode;
+}
+
+size_t PathCacheKeyHasher::operator()(const PathCacheKey& key) const
+{
+	size_t hash = static_cast<size_t>(static_cast<unsigned short>(key.m_start.x));
+	hash = (hash * 31) ^ static_cast<size_t>(static_cast<unsigned short>(key.m_start.y));
+	hash = (hash * 31) ^ static_cast<size_t>(static_cast<unsigned short>(key.m_goal.x));
+	hash = (hash * 31) ^ static_cast<size_t>(static_cast<unsigned short>(key.m_goal.y));
+	hash = (hash * 31) ^ static_cast<size_t>(key.m_directionMode);
+	hash = (hash * 31) ^ static_cast<size_t>(key.m_navigationMode);
+	return hash;
+}
+
+float PathCacheStats::GetHitRate() const
+{
+	unsigned int totalRequests = m_hits + m_subPathHits + m_misses;
+	if (totalRequests == 0)
+	{
+		return 0.f;
+	}
+	return static_cast<float>(m_hits + m_subPathHits) / static_cast<float>(totalRequests);
+}
+
+PathCache::PathCache(size_t maxEntries)
+	:m_maxEntries(maxEntries)
+{
+}
+
+bool PathCache::TryGetPath(const IntVec2& start, const IntVec2& goal, DirectionMode directionMode, NavigationMode navigationMode, std::vector<IntVec2>& outPath, PathCacheKey* outUsedKey) const
+{
+	PathCacheKey key;
+	key.m_start = start;
+	key.m_goal = goal;
+	key.m_directionMode = directionMode;
+	key.m_navigationMode = navigationMode;
+
+	std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+	auto found = m_entries.find(key);
+	if (found != m_entries.end())
+	{
+		outPath = found->second->m_path;
+		if (outUsedKey)
+		{
+			*outUsedKey = key;
+		}
+		++m_hits;
+		return true;
+	}
+
+	if (TryGetSubPath(key, outPath, outUsedKey))
+	{
+		++m_subPathHits;
+		return true;
+	}
+
+	++m_misses;
+	return false;
+}
+
+void PathCache::MarkUsed(const PathCacheKey& key)
+{
+	std::unique_lock<std::shared_mutex> lock(m_mutex);
+	auto found = m_entries.find(key);
+	if (found != m_entries.end())
+	{
+		m_recencyList.splice(m_recencyList.begin(), m_recencyList, found->second);
+	}
+}
+
+bool PathCache::TryGetSubPath(const PathCacheKey& key, std::vector<IntVec2>& outPath, PathCacheKey* outUsedKey) const
+{
+	if (key.m_start == key.m_goal)
+	{
+		return false;
+	}
+
+	auto entriesThroughGoal = m_entriesByTile.find(GetTileKey(key.m_goal));
+	if (entriesThroughGoal == m_entriesByTile.end())
+	{
+		return false;
+	}
+
+	// Any section of an optimal path is itself optimal, so a cached path that passes through the start and then the goal can serve the request
+	for (const Entry* candidate : entriesThroughGoal->second)
+	{
+		const Entry& entry = *candidate;
+		if (entry.m_key.m_directionMode != key.m_directionMode || entry.m_key.m_navigationMode != key.m_navigationMode)
+		{
+			continue;
+		}
+
+		if (key.m_start.x < entry.m_boundsMins.x || key.m_start.y < entry.m_boundsMins.y || key.m_start.x > entry.m_boundsMaxs.x || key.m_start.y > entry.m_boundsMaxs.y) continue;
+
+		// Travel order runs from the back of the path to the front, so the goal must sit at a lower index than the start
+		int goalIndex = -1;
+		int startIndex = -1;
+		for (int pathIndex = 0; pathIndex < static_cast<int>(entry.m_path.size()); pathIndex++)
+		{
+			if (goalIndex < 0 && entry.m_path[pathIndex] == key.m_goal)
+			{
+				goalIndex = pathIndex;
+			}
+			else if (goalIndex >= 0 && entry.m_path[pathIndex] == key.m_start)
+			{
+				startIndex = pathIndex;
+				break;
+			}
+		}
+
+		// Paths that leave out their own start tile can still serve requests from that same start
+		if (startIndex < 0 && goalIndex >= 0 && !entry.m_includesStart && entry.m_key.m_start == key.m_start)
+		{
+			startIndex = static_cast<int>(entry.m_path.size());
+		}
+
+		if (goalIndex < 0 || startIndex < 0)
+		{
+			continue;
+		}
+
+		// Match the layout GridAStar produced for this entry, with or without the start tile at the back
+		int endIndex = entry.m_includesStart ? startIndex + 1 : startIndex;
+		outPath.assign(entry.m_path.begin() + goalIndex, entry.m_path.begin() + endIndex);
+		if (outUsedKey)
+		{
+			*outUsedKey = entry.m_key;
+		}
+		return true;
+	}
+	return false;
+}
+
+void PathCache::AddPath(const IntVec2& start, const IntVec2& goal, DirectionMode directionMode, NavigationMode navigationMode, const std::vector<IntVec2>& path, unsigned int navVersion)
+{
+	// Empty results are not cached since they are usually caused by unreachable or out of bounds goals
+	if (path.empty() || path.front() != goal || m_maxEntries == 0)
+	{
+		return;
+	}
+
+	Entry newEntry;
+	newEntry.m_key.m_start = start;
+	newEntry.m_key.m_goal = goal;
+	newEntry.m_key.m_directionMode = directionMode;
+	newEntry.m_key.m_navigationMode = navigationMode;
+	newEntry.m_path = path;
+	newEntry.m_includesStart = (path.back() == start);
+	newEntry.m_boundsMins = start;
+	newEntry.m_boundsMaxs = start;
+	for (const IntVec2& tileCoords : path)
+	{
+		newEntry.m_boundsMins.x = std::min(newEntry.m_boundsMins.x, tileCoords.x);
+		newEntry.m_boundsMins.y = std::min(newEntry.m_boundsMins.y, tileCoords.y);
+		newEntry.m_boundsMaxs.x = std::max(newEntry.m_boundsMaxs.x, tileCoords.x);
+		newEntry.m_boundsMaxs.y = std::max(newEntry.m_boundsMaxs.y, tileCoords.y);
+	}
+
+	std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+	if (navVersion < m_minimumNavVersion)
+	{
+		m_staleInserts++;
+		return;
+	}
+
+	auto found = m_entries.find(newEntry.m_key);
+	if (found != m_entries.end())
+	{
+		RemoveEntry(found->second);
+	}
+	else if (m_entries.size() >= m_maxEntries)
+	{
+		EvictLeastRecentlyUsed();
+	}
+
+	m_recencyList.push_front(std::move(newEntry));
+	const Entry& entry = m_recencyList.front();
+	m_entries.emplace(entry.m_key, m_recencyList.begin());
+	for (const IntVec2& tileCoords : entry.m_path)
+	{
+		m_entriesByTile[GetTileKey(tileCoords)].push_back(&entry);
+	}
+	m_memoryBytes += GetEntryMemoryBytes(entry);
+}
+
+void PathCache::InvalidateRegion(const IntVec2& regionMins, const IntVec2& regionMaxs, unsigned int newNavVersion)
+{
+	std::unique_lock<std::shared_mutex> lock(m_mutex);
+	m_minimumNavVersion = std::max(m_minimumNavVersion, newNavVersion);
+
+	for (auto iter = m_recencyList.begin(); iter != m_recencyList.end();)
+	{
+		const Entry& entry = *iter;
+		bool overlapsRegion = entry.m_boundsMins.x <= regionMaxs.x && entry.m_boundsMaxs.x >= regionMins.x && entry.m_boundsMins.y <= regionMaxs.y && entry.m_boundsMaxs.y >= regionMins.y;
+		EntryIterator next = std::next(iter);
+		if (overlapsRegion)
+		{
+			RemoveEntry(iter);
+			m_invalidations++;
+		}
+		iter = next;
+	}
+}
+
+void PathCache::Clear()
+{
+	std::unique_lock<std::shared_mutex> lock(m_mutex);
+	m_entries.clear();
+	m_entriesByTile.clear();
+	m_recencyList.clear();
+	m_memoryBytes = 0;
+}
+
+PathCacheStats PathCache::GetStats() const
+{
+	std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+	PathCacheStats stats;
+	stats.m_hits = m_hits;
+	stats.m_subPathHits = m_subPathHits;
+	stats.m_misses = m_misses;
+	stats.m_evictions = m_evictions;
+	stats.m_invalidations = m_invalidations;
+	stats.m_staleInserts = m_staleInserts;
+	stats.m_numEntries = static_cast<unsigned int>(m_entries.size());
+	stats.m_memoryBytes = sizeof(PathCache) + m_memoryBytes;
+	return stats;
+}
+
+void PathCache::RemoveEntry(EntryIterator entry)
+{
+	// Order within a tile's list is kept so sub-path lookups keep preferring older entries
+	for (const IntVec2& tileCoords : entry->m_path)
+	{
+		auto tileEntries = m_entriesByTile.find(GetTileKey(tileCoords));
+		std::vector<const Entry*>& entries = tileEntries->second;
+		entries.erase(std::find(entries.begin(), entries.end(), &*entry));
+		if (entries.empty())
+		{
+			m_entriesByTile.erase(tileEntries);
+		}
+	}
+
+	m_memoryBytes -= GetEntryMemoryBytes(*entry);
+	m_entries.erase(entry->m_key);
+	m_recencyList.erase(entry);
+}
+
+void PathCache::EvictLeastRecentlyUsed()
+{
+	if (!m_recencyList.empty())
+	{
+		RemoveEntry(std::prev(m_recencyList.end()));
+		m_evictions++;
+	}
+}
+
+size_t PathCache::GetEntryMemoryBytes(const Entry& entry) const
+{
+	// List node holding the entry, its path storage, its key's hash node and its place in each tile list
+	return sizeof(Entry) + 2 * sizeof(void*) + entry.m_path.capacity() * (sizeof(IntVec2) + sizeof(const Entry*)) + sizeof(PathCacheKey) + 3 * sizeof(void*);
+}
+
+STATIC long long PathCache::GetTileKey(const IntVec2& tileCoords)
+{
+	return (static_cast<long long>(tileCoords.y) << 32) | static_cast<unsigned int>(tileCoords.x);
+}
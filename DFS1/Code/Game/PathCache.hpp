@@ -0,0 +1,95 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/AI/Pathfinding/Grid/GridAStar.hpp"
+#include "Game/NavRectGraph.hpp"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+#include <list>
+
+struct PathCacheKey
+{
+	IntVec2 m_start = IntVec2::ZERO;
+	IntVec2 m_goal = IntVec2::ZERO;
+	DirectionMode m_directionMode = DirectionMode::Cardinal8;
+	NavigationMode m_navigationMode = NavigationMode::TILE; // Rect routes are waypoints, tile routes list every step
+
+	bool operator==(const PathCacheKey& other) const;
+};
+
+struct PathCacheKeyHasher
+{
+	size_t operator()(const PathCacheKey& key) const;
+};
+
+struct PathCacheStats
+{
+	unsigned int m_hits = 0;
+	unsigned int m_subPathHits = 0;
+	unsigned int m_misses = 0;
+	unsigned int m_evictions = 0;
+	unsigned int m_invalidations = 0;
+	unsigned int m_staleInserts = 0;
+	unsigned int m_numEntries = 0;
+	size_t m_memoryBytes = 0;
+
+	float GetHitRate() const;
+};
+
+// Shared LRU cache of A* results owned by the map. Lookups only take a shared lock so pathfinding
+// workers can read concurrently, and leave the recency order alone; the caller reports the entry it
+// used through MarkUsed, which like inserts, evictions and invalidation takes the exclusive lock.
+// Entries are also listed under every tile of their path, so a sub-path lookup only looks at the
+// paths that pass through the goal.
+// Paths are stored exactly as GridAStar returns them (goal at the front, next step at the back).
+// Inserts carry the navigation snapshot version they were computed on, so a job that finishes after
+// an invalidation cannot put a path through the old walls back into the cache.
+class PathCache
+{
+public:
+	explicit PathCache(size_t maxEntries = 256);
+	~PathCache() = default;
+
+	bool TryGetPath(const IntVec2& start, const IntVec2& goal, DirectionMode directionMode, NavigationMode navigationMode, std::vector<IntVec2>& outPath, PathCacheKey* outUsedKey = nullptr) const;
+	void MarkUsed(const PathCacheKey& key);
+	void AddPath(const IntVec2& start, const IntVec2& goal, DirectionMode directionMode, NavigationMode navigationMode, const std::vector<IntVec2>& path, unsigned int navVersion);
+	void InvalidateRegion(const IntVec2& regionMins, const IntVec2& regionMaxs, unsigned int newNavVersion);
+	void Clear();
+
+	PathCacheStats GetStats() const;
+
+private:
+	struct Entry
+	{
+		PathCacheKey m_key;
+		std::vector<IntVec2> m_path;
+		IntVec2 m_boundsMins = IntVec2::ZERO;
+		IntVec2 m_boundsMaxs = IntVec2::ZERO;
+		bool m_includesStart = false;
+	};
+	typedef std::list<Entry>::iterator EntryIterator;
+
+	bool TryGetSubPath(const PathCacheKey& key, std::vector<IntVec2>& outPath, PathCacheKey* outUsedKey) const;
+	void RemoveEntry(EntryIterator entry);
+	void EvictLeastRecentlyUsed();
+	size_t GetEntryMemoryBytes(const Entry& entry) const;
+	static long long GetTileKey(const IntVec2& tileCoords);
+
+private:
+	mutable std::shared_mutex m_mutex;
+	std::list<Entry> m_recencyList; // Most recently used at the front
+	std::unordered_map<PathCacheKey, EntryIterator, PathCacheKeyHasher> m_entries;
+	std::unordered_map<long long, std::vector<const Entry*>> m_entriesByTile;
+	size_t m_maxEntries = 256;
+	size_t m_memoryBytes = 0;
+
+	mutable std::atomic<unsigned int> m_hits = 0;
+	mutable std::atomic<unsigned int> m_subPathHits = 0;
+	mutable std::atomic<unsigned int> m_misses = 0;
+	unsigned int m_evictions = 0;
+	unsigned int m_invalidations = 0;
+	unsigned int m_staleInserts = 0;
+	unsigned int m_minimumNavVersion = 0;
+};
@@ -0,0 +1,291 @@
+#include "Game/PatrolNetwork.hpp"
+#include "Game/NavSnapshot.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+void PatrolNetwork::Build(const NavSnapshot& navSnapshot, int waypointSpacing, bool isRandomizingBranches)
+{
+	auto buildStart = std::chrono::high_resolution_clock::now();
+
+	m_dimensions = navSnapshot.GetDimensions();
+	m_isRandomizingBranches = isRandomizingBranches;
+	m_waypoints.clear();
+	m_firstEdge.clear();
+	m_edges.clear();
+
+	PlaceWaypoints(navSnapshot, waypointSpacing > 1 ? waypointSpacing : 2);
+	FloodWaypointRegions(navSnapshot);
+	LinkWaypoints(navSnapshot);
+
+	auto buildEnd = std::chrono::high_resolution_clock::now();
+	m_lastBuildMS = std::chrono::duration<float, std::milli>(buildEnd - buildStart).count();
+}
+
+void PatrolNetwork::PlaceWaypoints(const NavSnapshot& navSnapshot, int waypointSpacing)
+{
+	for (int cellMinY = 0; cellMinY < m_dimensions.y; cellMinY += waypointSpacing)
+	{
+		for (int cellMinX = 0; cellMinX < m_dimensions.x; cellMinX += waypointSpacing)
+		{
+			int cellMaxX = std::min(cellMinX + waypointSpacing, m_dimensions.x) - 1;
+			int cellMaxY = std::min(cellMinY + waypointSpacing, m_dimensions.y) - 1;
+			int cellCenterX = (cellMinX + cellMaxX) / 2;
+			int cellCenterY = (cellMinY + cellMaxY) / 2;
+
+			// Junctions win over plain floor, ties go to whichever tile is closest to the middle of the cell
+			IntVec2 bestTile = IntVec2(-1, -1);
+			int bestJunctionScore = -1;
+			int bestDistanceSq = 0;
+			for (int tileY = cellMinY; tileY <= cellMaxY; tileY++)
+			{
+				for (int tileX = cellMinX; tileX <= cellMaxX; tileX++)
+				{
+					if (navSnapshot.IsSolidTile(tileX, tileY))
+					{
+						continue;
+					}
+
+					int numNeighbors = GetNumWalkableNeighbors(navSnapshot, tileX, tileY);
+					if (numNeighbors == 0)
+					{
+						continue;
+					}
+					int junctionScore = numNeighbors >= 3 ? 1 : 0;
+					int distanceSq = (tileX - cellCenterX) * (tileX - cellCenterX) + (tileY - cellCenterY) * (tileY - cellCenterY);
+					if (junctionScore > bestJunctionScore || (junctionScore == bestJunctionScore && distanceSq < bestDistanceSq))
+					{
+						bestTile = IntVec2(tileX, tileY);
+						bestJunctionScore = junctionScore;
+						bestDistanceSq = distanceSq;
+					}
+				}
+			}
+
+			if (bestJunctionScore >= 0)
+			{
+				m_waypoints.push_back(bestTile);
+			}
+		}
+	}
+}
+
+void PatrolNetwork::FloodWaypointRegions(const NavSnapshot& navSnapshot)
+{
+	// Breadth first from every waypoint at once, each tile belongs to whichever waypoint reached it first
+	m_nearestWaypoint.assign(static_cast<size_t>(m_dimensions.x) * m_dimensions.y, -1);
+	std::vector<int> openTiles;
+	openTiles.reserve(m_nearestWaypoint.size());
+	for (int waypointIndex = 0; waypointIndex < static_cast<int>(m_waypoints.size()); waypointIndex++)
+	{
+		int tileIndex = m_waypoints[waypointIndex].x + m_waypoints[waypointIndex].y * m_dimensions.x;
+		m_nearestWaypoint[tileIndex] = waypointIndex;
+		openTiles.push_back(tileIndex);
+	}
+
+	const IntVec2 neighborOffsets[4] = { IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1) };
+	for (size_t openIndex = 0; openIndex < openTiles.size(); openIndex++)
+	{
+		int tileIndex = openTiles[openIndex];
+		int tileX = tileIndex % m_dimensions.x;
+		int tileY = tileIndex / m_dimensions.x;
+		for (const IntVec2& offset : neighborOffsets)
+		{
+			int neighborX = tileX + offset.x;
+			int neighborY = tileY + offset.y;
+			if (neighborX < 0 || neighborY < 0 || neighborX >= m_dimensions.x || neighborY >= m_dimensions.y || navSnapshot.IsSolidTile(neighborX, neighborY))
+			{
+				continue;
+			}
+
+			int neighborIndex = neighborX + neighborY * m_dimensions.x;
+			if (m_nearestWaypoint[neighborIndex] < 0)
+			{
+				m_nearestWaypoint[neighborIndex] = m_nearestWaypoint[tileIndex];
+				openTiles.push_back(neighborIndex);
+			}
+		}
+	}
+}
+
+void PatrolNetwork::LinkWaypoints(const NavSnapshot& navSnapshot)
+{
+	// Two waypoints are neighbors when their regions share a tile edge
+	std::vector<std::pair<int, int>> links;
+	for (int tileY = 0; tileY < m_dimensions.y; tileY++)
+	{
+		for (int tileX = 0; tileX < m_dimensions.x; tileX++)
+		{
+			int region = m_nearestWaypoint[tileX + tileY * m_dimensions.x];
+			if (region < 0)
+			{
+				continue;
+			}
+
+			int rightRegion = tileX + 1 < m_dimensions.x ? m_nearestWaypoint[tileX + 1 + tileY * m_dimensions.x] : -1;
+			int upRegion = tileY + 1 < m_dimensions.y ? m_nearestWaypoint[tileX + (tileY + 1) * m_dimensions.x] : -1;
+			if (rightRegion >= 0 && rightRegion != region)
+			{
+				links.push_back(std::make_pair(std::min(region, rightRegion), std::max(region, rightRegion)));
+			}
+			if (upRegion >= 0 && upRegion != region)
+			{
+				links.push_back(std::make_pair(std::min(region, upRegion), std::max(region, upRegion)));
+			}
+		}
+	}
+	std::sort(links.begin(), links.end());
+	links.erase(std::unique(links.begin(), links.end()), links.end());
+
+	// Each link is walked both ways, so both directions get their own stored path
+	std::vector<std::pair<int, int>> directedLinks;
+	directedLinks.reserve(links.size() * 2);
+	for (const std::pair<int, int>& link : links)
+	{
+		directedLinks.push_back(link);
+		directedLinks.push_back(std::make_pair(link.second, link.first));
+	}
+	std::sort(directedLinks.begin(), directedLinks.end());
+
+	const NavRectGraph* rectGraph = navSnapshot.GetRectGraph();
+	GridAStar pathfinder(m_dimensions);
+	pathfinder.SetDirectionMode(DirectionMode::Cardinal8);
+	navSnapshot.ConfigureGridAStar(pathfinder);
+
+	int numWaypoints = static_cast<int>(m_waypoints.size());
+	m_firstEdge.assign(numWaypoints + 1, 0);
+	m_edges.reserve(directedLinks.size());
+	for (const std::pair<int, int>& directedLink : directedLinks)
+	{
+		PatrolEdge edge;
+		edge.m_toWaypoint = directedLink.second;
+		if (rectGraph)
+		{
+			rectGraph->FindPath(m_waypoints[directedLink.first], m_waypoints[directedLink.second], edge.m_path);
+		}
+		else
+		{
+			pathfinder.ComputeAStar(m_waypoints[directedLink.first], m_waypoints[directedLink.second], edge.m_path);
+		}
+
+		if (!edge.m_path.empty())
+		{
+			m_edges.push_back(std::move(edge));
+			m_firstEdge[directedLink.first + 1]++;
+		}
+	}
+
+	for (int waypointIndex = 0; waypointIndex < numWaypoints; waypointIndex++)
+	{
+		m_firstEdge[waypointIndex + 1] += m_firstEdge[waypointIndex];
+	}
+}
+
+int PatrolNetwork::GetNumWalkableNeighbors(const NavSnapshot& navSnapshot, int tileX, int tileY) const
+{
+	int numNeighbors = 0;
+	if (tileX + 1 < m_dimensions.x && !navSnapshot.IsSolidTile(tileX + 1, tileY)) numNeighbors++;
+	if (tileX - 1 >= 0 && !navSnapshot.IsSolidTile(tileX - 1, tileY)) numNeighbors++;
+	if (tileY + 1 < m_dimensions.y && !navSnapshot.IsSolidTile(tileX, tileY + 1)) numNeighbors++;
+	if (tileY - 1 >= 0 && !navSnapshot.IsSolidTile(tileX, tileY - 1)) numNeighbors++;
+	return numNeighbors;
+}
+
+bool PatrolNetwork::IsEmpty() const
+{
+	return m_edges.empty();
+}
+
+int PatrolNetwork::GetNumWaypoints() const
+{
+	return static_cast<int>(m_waypoints.size());
+}
+
+int PatrolNetwork::GetNumEdges() const
+{
+	return static_cast<int>(m_edges.size());
+}
+
+float PatrolNetwork::GetLastBuildMS() const
+{
+	return m_lastBuildMS;
+}
+
+IntVec2 PatrolNetwork::GetWaypointCoords(int waypointIndex) const
+{
+	return m_waypoints[waypointIndex];
+}
+
+int PatrolNetwork::GetNearestWaypoint(const IntVec2& tileCoords) const
+{
+	if (tileCoords.x < 0 || tileCoords.y < 0 || tileCoords.x >= m_dimensions.x || tileCoords.y >= m_dimensions.y)
+	{
+		return -1;
+	}
+	return m_nearestWaypoint[tileCoords.x + tileCoords.y * m_dimensions.x];
+}
+
+int PatrolNetwork::GetWaypointAtTile(const IntVec2& tileCoords) const
+{
+	int waypointIndex = GetNearestWaypoint(tileCoords);
+	if (waypointIndex >= 0 && m_waypoints[waypointIndex] == tileCoords)
+	{
+		return waypointIndex;
+	}
+	return -1;
+}
+
+const std::vector<IntVec2>& PatrolNetwork::GetWaypoints() const
+{
+	return m_waypoints;
+}
+
+const PatrolEdge* PatrolNetwork::ChooseNextEdge(int currentWaypoint, int previousWaypoint, RandomNumberGenerator& rng) const
+{
+	if (currentWaypoint < 0 || currentWaypoint >= static_cast<int>(m_waypoints.size()))
+	{
+		return nullptr;
+	}
+
+	int firstEdge = m_firstEdge[currentWaypoint];
+	int numEdges = m_firstEdge[currentWaypoint + 1] - firstEdge;
+	if (numEdges == 0)
+	{
+		return nullptr;
+	}
+
+	// Turning back is only allowed at dead ends
+	int backEdge = -1;
+	for (int edgeIndex = firstEdge; edgeIndex < firstEdge + numEdges; edgeIndex++)
+	{
+		if (m_edges[edgeIndex].m_toWaypoint == previousWaypoint)
+		{
+			backEdge = edgeIndex;
+		}
+	}
+	if (backEdge >= 0 && numEdges == 1)
+	{
+		return &m_edges[backEdge];
+	}
+
+	int numChoices = backEdge >= 0 ? numEdges - 1 : numEdges;
+	if (m_isRandomizingBranches)
+	{
+		int choice = rng.SRollRandomIntInRange(0, numChoices - 1);
+		int edgeIndex = firstEdge + choice;
+		if (backEdge >= 0 && edgeIndex >= backEdge)
+		{
+			edgeIndex++;
+		}
+		return &m_edges[edgeIndex];
+	}
+
+	// Without randomness take the next edge round from the one we arrived on, which walks loops consistently
+	int edgeIndex = backEdge >= 0 ? backEdge + 1 : firstEdge;
+	if (edgeIndex >= firstEdge + numEdges)
+	{
+		edgeIndex = firstEdge;
+	}
+	return &m_edges[edgeIndex];
+}
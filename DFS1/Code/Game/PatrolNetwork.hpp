@@ -0,0 +1,53 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include <vector>
+
+class NavSnapshot;
+class RandomNumberGenerator;
+
+struct PatrolEdge
+{
+	int m_toWaypoint = -1;
+	std::vector<IntVec2> m_path; // Same order as AIActor::m_aiPath, the next tile to walk to is at the back
+};
+
+// Sparse graph of patrol waypoints built once per map. Every cell of a coarse grid gets one waypoint,
+// placed on a corridor junction when the cell has one. Waypoints whose flood regions touch are linked and
+// the path along every link is computed up front, so patrolling AIs only walk stored paths. The flood
+// also records the closest waypoint for every tile, which is where AIs head to rejoin the network.
+class PatrolNetwork
+{
+public:
+	PatrolNetwork() = default;
+	~PatrolNetwork() = default;
+
+	void Build(const NavSnapshot& navSnapshot, int waypointSpacing, bool isRandomizingBranches);
+
+	bool IsEmpty() const;
+	int GetNumWaypoints() const;
+	int GetNumEdges() const;
+	float GetLastBuildMS() const;
+
+	IntVec2 GetWaypointCoords(int waypointIndex) const;
+	int GetNearestWaypoint(const IntVec2& tileCoords) const;
+	int GetWaypointAtTile(const IntVec2& tileCoords) const;
+	const std::vector<IntVec2>& GetWaypoints() const;
+	const PatrolEdge* ChooseNextEdge(int currentWaypoint, int previousWaypoint, RandomNumberGenerator& rng) const;
+
+private:
+	void PlaceWaypoints(const NavSnapshot& navSnapshot, int waypointSpacing);
+	void FloodWaypointRegions(const NavSnapshot& navSnapshot);
+	void LinkWaypoints(const NavSnapshot& navSnapshot);
+	int GetNumWalkableNeighbors(const NavSnapshot& navSnapshot, int tileX, int tileY) const;
+
+private:
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	float m_lastBuildMS = 0.f;
+	bool m_isRandomizingBranches = true;
+	std::vector<IntVec2> m_waypoints;
+	std::vector<int> m_nearestWaypoint; // Per tile, -1 for solid or unreachable tiles
+
+	// Edges are grouped by their start waypoint, m_firstEdge[i] to m_firstEdge[i + 1] are waypoint i's
+	std::vector<int> m_firstEdge;
+	std::vector<PatrolEdge> m_edges;
+};
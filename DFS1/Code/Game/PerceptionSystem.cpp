@@ -0,0 +1,332 @@
+#include "Game/PerceptionSystem.hpp"
+#include "Game/Map.hpp"
+#include "Game/Actor.hpp"
+#include "Game/AIActor.hpp"
+#include "Game/NavSnapshot.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <chrono>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PERCEPTION_USE_SSE
+#endif
+
+void PerceptionSystem::Update(Map* map)
+{
+	auto updateStart = std::chrono::high_resolution_clock::now();
+
+	GatherAgents(map);
+	m_candidates.clear();
+	m_reachedPlayer.clear();
+
+	Actor* playerActor = map->GetPlayerActor();
+	if (playerActor != nullptr && m_numAgents > 0)
+	{
+		PrefilterAgents(playerActor->m_position);
+		CastRaysAgainstTiles(map, playerActor->m_position, playerActor->m_physicsRadius);
+		ConfirmRaysAgainstActors(map, playerActor->m_position);
+	}
+	m_numRaysCast = static_cast<int>(m_candidates.size());
+
+	auto updateEnd = std::chrono::high_resolution_clock::now();
+	m_lastUpdateMS = std::chrono::duration<float, std::milli>(updateEnd - updateStart).count();
+}
+
+bool PerceptionSystem::CanSeePlayer(int perceptionIndex) const
+{
+	if (perceptionIndex < 0 || perceptionIndex >= m_numAgents)
+	{
+		return false;
+	}
+	return m_canSeePlayer[perceptionIndex] != 0;
+}
+
+bool PerceptionSystem::WasRayCast(int perceptionIndex) const
+{
+	if (perceptionIndex < 0 || perceptionIndex >= m_numAgents)
+	{
+		return false;
+	}
+	return m_wasRayCast[perceptionIndex] != 0;
+}
+
+float PerceptionSystem::GetRayLength(int perceptionIndex) const
+{
+	if (perceptionIndex < 0 || perceptionIndex >= m_numAgents)
+	{
+		return 0.f;
+	}
+	return m_rayLengths[perceptionIndex];
+}
+
+int PerceptionSystem::GetNumAgents() const
+{
+	return m_numAgents;
+}
+
+int PerceptionSystem::GetNumRaysCast() const
+{
+	return m_numRaysCast;
+}
+
+float PerceptionSystem::GetLastUpdateMS() const
+{
+	return m_lastUpdateMS;
+}
+
+void PerceptionSystem::GatherAgents(Map* map)
+{
+	m_controllers.clear();
+	m_eyeX.clear();
+	m_eyeY.clear();
+	m_eyeZ.clear();
+	m_forwardX.clear();
+	m_forwardY.clear();
+	m_sightDistanceSq.clear();
+	m_cosSightFOV.clear();
+	m_sensorRadiusSq.clear();
+
+	for (Actor* actor : map->m_actors)
+	{
+		if (actor == nullptr || !actor->m_isAI)
+		{
+			continue;
+		}
+
+		AIActor* aiController = actor->GetAiController();
+		if (aiController == nullptr)
+		{
+			continue;
+		}
+
+		// Sight is tested against the yaw only, the same as comparing angles about Z
+		Vec3 forward = actor->m_orientation.GetForwardVector();
+		float forwardLength = sqrtf(forward.x * forward.x + forward.y * forward.y);
+		float forwardX = forwardLength > 0.f ? forward.x / forwardLength : 1.f;
+		float forwardY = forwardLength > 0.f ? forward.y / forwardLength : 0.f;
+
+		aiController->m_perceptionIndex = static_cast<int>(m_controllers.size());
+		m_controllers.push_back(aiController);
+		m_eyeX.push_back(actor->m_position.x);
+		m_eyeY.push_back(actor->m_position.y);
+		m_eyeZ.push_back(actor->m_position.z + actor->m_eyeHeight);
+		m_forwardX.push_back(forwardX);
+		m_forwardY.push_back(forwardY);
+		m_sightDistanceSq.push_back(aiController->m_sightDistance * aiController->m_sightDistance);
+		m_cosSightFOV.push_back(aiController->m_sightFOV >= 180.f ? -1.f : CosDegrees(aiController->m_sightFOV));
+		m_sensorRadiusSq.push_back(aiController->m_sensorRadius * aiController->m_sensorRadius);
+	}
+
+	m_numAgents = static_cast<int>(m_controllers.size());
+	int paddedSize = (m_numAgents + 3) & ~3;
+	m_eyeX.resize(paddedSize, 0.f);
+	m_eyeY.resize(paddedSize, 0.f);
+	m_eyeZ.resize(paddedSize, 0.f);
+	m_forwardX.resize(paddedSize, 1.f);
+	m_forwardY.resize(paddedSize, 0.f);
+	m_sightDistanceSq.resize(paddedSize, -1.f);
+	m_cosSightFOV.resize(paddedSize, 1.f);
+	m_sensorRadiusSq.resize(paddedSize, -1.f);
+
+	m_canSeePlayer.assign(m_numAgents, 0);
+	m_wasRayCast.assign(m_numAgents, 0);
+	m_rayLengths.assign(m_numAgents, 0.f);
+}
+
+void PerceptionSystem::PrefilterAgents(const Vec3& playerPosition)
+{
+	int paddedSize = static_cast<int>(m_eyeX.size());
+
+#ifdef PERCEPTION_USE_SSE
+	__m128 playerX = _mm_set1_ps(playerPosition.x);
+	__m128 playerY = _mm_set1_ps(playerPosition.y);
+	for (int agentIndex = 0; agentIndex < paddedSize; agentIndex += 4)
+	{
+		__m128 deltaX = _mm_sub_ps(playerX, _mm_loadu_ps(&m_eyeX[agentIndex]));
+		__m128 deltaY = _mm_sub_ps(playerY, _mm_loadu_ps(&m_eyeY[agentIndex]));
+		__m128 distanceSq = _mm_add_ps(_mm_mul_ps(deltaX, deltaX), _mm_mul_ps(deltaY, deltaY));
+		__m128 distance = _mm_sqrt_ps(distanceSq);
+		__m128 forwardDot = _mm_add_ps(_mm_mul_ps(deltaX, _mm_loadu_ps(&m_forwardX[agentIndex])), _mm_mul_ps(deltaY, _mm_loadu_ps(&m_forwardY[agentIndex])));
+
+		// Inside the cone when the angle to the player is within the FOV, i.e. dot >= cos(FOV) * distance
+		__m128 isInSightRange = _mm_cmple_ps(distanceSq, _mm_loadu_ps(&m_sightDistanceSq[agentIndex]));
+		__m128 isInCone = _mm_cmpge_ps(forwardDot, _mm_mul_ps(distance, _mm_loadu_ps(&m_cosSightFOV[agentIndex])));
+		__m128 isInSensorRadius = _mm_cmple_ps(distanceSq, _mm_loadu_ps(&m_sensorRadiusSq[agentIndex]));
+		int passedMask = _mm_movemask_ps(_mm_or_ps(_mm_and_ps(isInSightRange, isInCone), isInSensorRadius));
+
+		while (passedMask != 0)
+		{
+			int lane = 0;
+			while ((passedMask & (1 << lane)) == 0)
+			{
+				lane++;
+			}
+			m_candidates.push_back(agentIndex + lane);
+			passedMask &= ~(1 << lane);
+		}
+	}
+#else
+	for (int agentIndex = 0; agentIndex < paddedSize; agentIndex++)
+	{
+		float deltaX = playerPosition.x - m_eyeX[agentIndex];
+		float deltaY = playerPosition.y - m_eyeY[agentIndex];
+		float distanceSq = deltaX * deltaX + deltaY * deltaY;
+		float forwardDot = deltaX * m_forwardX[agentIndex] + deltaY * m_forwardY[agentIndex];
+
+		bool isInCone = distanceSq <= m_sightDistanceSq[agentIndex] && forwardDot >= sqrtf(distanceSq) * m_cosSightFOV[agentIndex];
+		bool isInSensorRadius = distanceSq <= m_sensorRadiusSq[agentIndex];
+		if (isInCone || isInSensorRadius)
+		{
+			m_candidates.push_back(agentIndex);
+		}
+	}
+#endif
+}
+
+void PerceptionSystem::CastRaysAgainstTiles(const Map* map, const Vec3& playerPosition, float playerRadius)
+{
+	const std::vector<unsigned char>& solidTiles = map->m_navSnapshot->GetSolidTiles();
+	IntVec2 dimensions = map->m_navSnapshot->GetDimensions();
+
+	int numRays = static_cast<int>(m_candidates.size());
+	m_rayTileX.resize(numRays);
+	m_rayTileY.resize(numRays);
+	m_rayStepX.resize(numRays);
+	m_rayStepY.resize(numRays);
+	m_rayNextCrossingX.resize(numRays);
+	m_rayNextCrossingY.resize(numRays);
+	m_rayDistPerCrossingX.resize(numRays);
+	m_rayDistPerCrossingY.resize(numRays);
+	m_rayEndDist.resize(numRays);
+	m_activeRays.clear();
+
+	auto isSolid = [&](int tileX, int tileY)
+	{
+		if (tileX < 0 || tileY < 0 || tileX >= dimensions.x || tileY >= dimensions.y)
+		{
+			return false;
+		}
+		return solidTiles[tileX + tileY * dimensions.x] != 0;
+	};
+
+	// Same grid walk as Map::RaycastWorldXY, set up for every ray before any of them steps
+	for (int rayIndex = 0; rayIndex < numRays; rayIndex++)
+	{
+		int agentIndex = m_candidates[rayIndex];
+		m_wasRayCast[agentIndex] = 1;
+
+		float startX = m_eyeX[agentIndex];
+		float startY = m_eyeY[agentIndex];
+		float deltaX = playerPosition.x - startX;
+		float deltaY = playerPosition.y - startY;
+		float distance = sqrtf(deltaX * deltaX + deltaY * deltaY);
+
+		// Walls only span heights 0 to 1, and a player standing on the eye has nothing between them
+		float eyeZ = m_eyeZ[agentIndex];
+		if (distance <= 0.f || eyeZ > 1.f || eyeZ < 0.f)
+		{
+			m_reachedPlayer.push_back(rayIndex);
+			continue;
+		}
+
+		int tileX = RoundDownToInt(startX);
+		int tileY = RoundDownToInt(startY);
+		if (isSolid(tileX, tileY))
+		{
+			m_rayLengths[agentIndex] = 0.f;
+			continue;
+		}
+
+		float directionX = deltaX / distance;
+		float directionY = deltaY / distance;
+		m_rayTileX[rayIndex] = tileX;
+		m_rayTileY[rayIndex] = tileY;
+		m_rayStepX[rayIndex] = (directionX > 0) ? 1 : -1;
+		m_rayStepY[rayIndex] = (directionY > 0) ? 1 : -1;
+		m_rayDistPerCrossingX[rayIndex] = 1.f / fabsf(directionX);
+		m_rayDistPerCrossingY[rayIndex] = 1.f / fabsf(directionY);
+		m_rayNextCrossingX[rayIndex] = fabsf(tileX + (m_rayStepX[rayIndex] + 1) / 2.f - startX) * m_rayDistPerCrossingX[rayIndex];
+		m_rayNextCrossingY[rayIndex] = fabsf(tileY + (m_rayStepY[rayIndex] + 1) / 2.f - startY) * m_rayDistPerCrossingY[rayIndex];
+		m_rayEndDist[rayIndex] = distance - playerRadius;
+		m_activeRays.push_back(rayIndex);
+	}
+
+	// Every pass moves each unfinished ray across one tile edge, finished rays are swapped out of the active list
+	int numActive = static_cast<int>(m_activeRays.size());
+	while (numActive > 0)
+	{
+		for (int activeIndex = 0; activeIndex < numActive;)
+		{
+			int rayIndex = m_activeRays[activeIndex];
+			bool crossesX = m_rayNextCrossingX[rayIndex] < m_rayNextCrossingY[rayIndex];
+			float crossingDist = crossesX ? m_rayNextCrossingX[rayIndex] : m_rayNextCrossingY[rayIndex];
+
+			bool isFinished = false;
+			if (crossingDist > m_rayEndDist[rayIndex])
+			{
+				m_reachedPlayer.push_back(rayIndex);
+				isFinished = true;
+			}
+			else
+			{
+				if (crossesX)
+				{
+					m_rayTileX[rayIndex] += m_rayStepX[rayIndex];
+					m_rayNextCrossingX[rayIndex] += m_rayDistPerCrossingX[rayIndex];
+				}
+				else
+				{
+					m_rayTileY[rayIndex] += m_rayStepY[rayIndex];
+					m_rayNextCrossingY[rayIndex] += m_rayDistPerCrossingY[rayIndex];
+				}
+
+				if (isSolid(m_rayTileX[rayIndex], m_rayTileY[rayIndex]))
+				{
+					m_rayLengths[m_candidates[rayIndex]] = crossingDist;
+					isFinished = true;
+				}
+			}
+
+			if (isFinished)
+			{
+				numActive--;
+				m_activeRays[activeIndex] = m_activeRays[numActive];
+			}
+			else
+			{
+				activeIndex++;
+			}
+		}
+	}
+}
+
+void PerceptionSystem::ConfirmRaysAgainstActors(const Map* map, const Vec3& playerPosition)
+{
+	// Another actor standing between the AI and the player still blocks the view
+	for (int rayIndex : m_reachedPlayer)
+	{
+		int agentIndex = m_candidates[rayIndex];
+		Actor* aiActor = m_controllers[agentIndex]->GetActor();
+
+		Vec3 eyePos = Vec3(m_eyeX[agentIndex], m_eyeY[agentIndex], m_eyeZ[agentIndex]);
+		Vec3 displacement = Vec3(playerPosition.x - eyePos.x, playerPosition.y - eyePos.y, 0.f);
+		float distance = displacement.GetLength();
+		if (distance <= 0.f)
+		{
+			m_canSeePlayer[agentIndex] = 1;
+			continue;
+		}
+
+		RaycastResult actorsResult = map->RaycastWorldActors(aiActor, eyePos, displacement.GetNormalized(), distance);
+		if (actorsResult.m_didImpact && actorsResult.m_impactedActor && actorsResult.m_impactedActor->IsPlayer())
+		{
+			m_canSeePlayer[agentIndex] = 1;
+			m_rayLengths[agentIndex] = actorsResult.m_impactDist;
+		}
+		else
+		{
+			m_rayLengths[agentIndex] = actorsResult.m_didImpact ? actorsResult.m_impactDist : distance;
+		}
+	}
+}
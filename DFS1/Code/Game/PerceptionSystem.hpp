@@ -0,0 +1,69 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+
+class Map;
+class Actor;
+class AIActor;
+
+// Per-frame sight test of every AI against the player. Eye positions, facing and sense ranges are
+// gathered into flat arrays so the distance and cone tests run four AIs at a time. The rays that pass
+// walk the tile grid together one crossing per pass, and only the few that reach the player without
+// hitting a wall are checked against other actors. AIActor::CanSeeTarget reads the results.
+class PerceptionSystem
+{
+public:
+	PerceptionSystem() = default;
+	~PerceptionSystem() = default;
+
+	void Update(Map* map);
+
+	bool CanSeePlayer(int perceptionIndex) const;
+	bool WasRayCast(int perceptionIndex) const;
+	float GetRayLength(int perceptionIndex) const;
+
+	int GetNumAgents() const;
+	int GetNumRaysCast() const;
+	float GetLastUpdateMS() const;
+
+private:
+	void GatherAgents(Map* map);
+	void PrefilterAgents(const Vec3& playerPosition);
+	void CastRaysAgainstTiles(const Map* map, const Vec3& playerPosition, float playerRadius);
+	void ConfirmRaysAgainstActors(const Map* map, const Vec3& playerPosition);
+
+private:
+	int m_numAgents = 0;
+	int m_numRaysCast = 0;
+	float m_lastUpdateMS = 0.f;
+
+	// Agent arrays are padded to a multiple of four, padding entries never pass the prefilter
+	std::vector<AIActor*> m_controllers;
+	std::vector<float> m_eyeX;
+	std::vector<float> m_eyeY;
+	std::vector<float> m_eyeZ;
+	std::vector<float> m_forwardX;
+	std::vector<float> m_forwardY;
+	std::vector<float> m_sightDistanceSq;
+	std::vector<float> m_cosSightFOV;
+	std::vector<float> m_sensorRadiusSq;
+
+	std::vector<int> m_candidates;
+	std::vector<int> m_reachedPlayer;
+
+	// Grid walk state for each candidate ray
+	std::vector<int> m_rayTileX;
+	std::vector<int> m_rayTileY;
+	std::vector<int> m_rayStepX;
+	std::vector<int> m_rayStepY;
+	std::vector<float> m_rayNextCrossingX;
+	std::vector<float> m_rayNextCrossingY;
+	std::vector<float> m_rayDistPerCrossingX;
+	std::vector<float> m_rayDistPerCrossingY;
+	std::vector<float> m_rayEndDist;
+	std::vector<int> m_activeRays;
+
+	std::vector<unsigned char> m_canSeePlayer;
+	std::vector<unsigned char> m_wasRayCast;
+	std::vector<float> m_rayLengths;
+};
@@ -33,6 +33,7 @@ void Player::Update()
 	float deltaSeconds = m_game->m_clock->GetDeltaSeconds();
 	Actor* actor = m_game->m_currentMap->GetActorByUID(m_actorUID);
 	actor->m_orientation.m_pitchDegrees = GetClamped(actor->m_orientation.m_pitchDegrees, -85.f, 85.f);
+	m_isMoveInputHeld = false;
 
 	if (g_theInput->WasKeyJustPressed(KEYCODE_F9))
 	{
@@ -63,32 +64,65 @@ void Player::Update()
 			
 			FreeFlyMouseMovementUpdate();
 			FreeFlyKeyInputUpdate(deltaSeconds);
-
-			m_playerWorldView.SetPerspectiveView(2.f, 60.f, 0.1f, 1000.f);
-			m_playerWorldView.SetRenderBasis(Vec3(0.f, 0.f, 1.f), Vec3(-1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
-			m_playerWorldView.SetTransform(m_position, m_orientation);
 		}
 		else if (m_currentCameraMode == CameraMode::MAP)
 		{
-			m_position = actor->m_position + Vec3(0.f, 0.f, actor->m_eyeHeight);
-			m_orientation = actor->m_orientation;
-			
- 			Vec3 camPosition = actor->m_position + Vec3(0.f, -10.f, 50.f);
- 			EulerAngles camOrientation = EulerAngles(90.f, 60.f, 0.f);				
-			ControlledActorMovement();		
- 			m_playerWorldView.SetPerspectiveView(2.f, 50.f, 0.1f, 1000.f);
- 			m_playerWorldView.SetRenderBasis(Vec3(0.f, 0.f, 1.f), Vec3(-1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
- 			m_playerWorldView.SetTransform(camPosition, camOrientation);
+			ControlledActorMovement();
 
 			if (actor->m_health <= 0)
 			{
-				actor->m_isDead = true;
+				actor->Die();
 				actor->m_isMoveable = false;
 			}
 		}
 	}
 }
 
+void Player::UpdateStep()
+{
+	// Input is read once per frame in Update, the movement it asked for is applied on every simulation step
+	if (!m_isMoveInputHeld)
+	{
+		return;
+	}
+
+	Actor* actor = m_game->m_currentMap->GetActorByUID(m_actorUID);
+	if (actor == nullptr)
+	{
+		return;
+	}
+	actor->TurnInDirection(m_moveYaw, 5.f);
+	actor->MoveInDirection(m_moveDirection, m_controlledMovementSpeed);
+}
+
+void Player::UpdateCamera(const RenderSnapshot& snapshot)
+{
+	if (m_currentCameraMode == CameraMode::FREEFLY)
+	{
+		m_playerWorldView.SetPerspectiveView(2.f, 60.f, 0.1f, 1000.f);
+		m_playerWorldView.SetRenderBasis(Vec3(0.f, 0.f, 1.f), Vec3(-1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+		m_playerWorldView.SetTransform(m_position, m_orientation);
+	}
+	else if (m_currentCameraMode == CameraMode::MAP)
+	{
+		if (!snapshot.m_hasPlayerActor)
+		{
+			return;
+		}
+
+		// Follows the blended transform the actor is drawn with, not the latest simulation step
+		Vec3 actorPosition = snapshot.m_playerPosition;
+		m_position = actorPosition + Vec3(0.f, 0.f, snapshot.m_playerEyeHeight);
+		m_orientation = snapshot.m_playerOrientation;
+
+		Vec3 camPosition = actorPosition + Vec3(0.f, -10.f, 50.f);
+		EulerAngles camOrientation = EulerAngles(90.f, 60.f, 0.f);
+		m_playerWorldView.SetPerspectiveView(2.f, 50.f, 0.1f, 1000.f);
+		m_playerWorldView.SetRenderBasis(Vec3(0.f, 0.f, 1.f), Vec3(-1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+		m_playerWorldView.SetTransform(camPosition, camOrientation);
+	}
+}
+
 void Player::FreeFlyKeyInputUpdate(float& deltaSeconds)
 {
 	const float turnRate = 90.f;
@@ -234,8 +268,9 @@ void Player::ControlledActorMovement()
 	if (directionalMovement.GetLength() > 0)
 	{
 		directionalMovement.Normalize();
-		actor->TurnInDirection(desiredYaw, 5.f);
-		actor->MoveInDirection(directionalMovement, m_controlledMovementSpeed);
+		m_moveDirection = directionalMovement;
+		m_moveYaw = desiredYaw;
+		m_isMoveInputHeld = true;
 	}
 }
 
@@ -7,6 +7,7 @@ class Camera;
 class Clock;
 class Game;
 class Actor;
+class RenderSnapshot;
 
 enum CameraMode
 {
@@ -23,6 +24,8 @@ public:
 	virtual ~Player();
 	virtual void Render();
 	virtual void Update();
+	virtual void UpdateStep();
+	void UpdateCamera(const RenderSnapshot& snapshot);
 	
 	void FreeFlyMouseMovementUpdate();
 	void FreeFlyKeyInputUpdate(float& deltaSeconds);
@@ -39,6 +42,9 @@ public:
 	Camera m_playerUICamera;
 	float m_movementSpeed = 2.f;
 	float m_controlledMovementSpeed = 0.f;
+	Vec3 m_moveDirection = Vec3::ZERO;
+	float m_moveYaw = 0.f;
+	bool m_isMoveInputHeld = false;
 	float m_camerAspectRatio = 2.f;
 	bool m_isShowingDebugOptions = false;
 	CameraMode m_currentCameraMode = CameraMode::NUM_CAM_MODES;
@@ -0,0 +1,104 @@
+#include "Game/RenderSnapshot.hpp"
+
+void RenderSnapshot::Clear()
+{
+	m_actors.clear();
+	m_debugOverlayLines.clear();
+	m_debugPrimitives.clear();
+}
+
+void RenderSnapshot::SubmitDebugPrimitives() const
+{
+	for (const SnapshotDebugPrimitive& primitive : m_debugPrimitives)
+	{
+		switch (primitive.m_shape)
+		{
+		case SnapshotDebugShape::WORLD_LINE:
+			DebugAddWorldLine(primitive.m_transform, primitive.m_length, primitive.m_radius, primitive.m_numSides, primitive.m_duration, primitive.m_startColor, primitive.m_endColor, primitive.m_mode);
+			break;
+		case SnapshotDebugShape::WORLD_RING:
+			DebugAddWorld3DRing(primitive.m_position, primitive.m_radius, primitive.m_numSides, primitive.m_thickness, primitive.m_duration, primitive.m_startColor, primitive.m_endColor, primitive.m_mode);
+			break;
+		case SnapshotDebugShape::WORLD_TRIANGLE:
+			DebugAddWorld3DTriangle(primitive.m_transform, primitive.m_position, primitive.m_radius, primitive.m_length, primitive.m_duration, primitive.m_startColor, primitive.m_endColor, primitive.m_mode);
+			break;
+		case SnapshotDebugShape::WORLD_WIRE_TRIANGLE:
+			DebugAddWorld3DWireTriangle(primitive.m_transform, primitive.m_position, primitive.m_radius, primitive.m_length, primitive.m_duration, primitive.m_startColor, primitive.m_endColor, primitive.m_mode);
+			break;
+		case SnapshotDebugShape::WORLD_QUAD:
+			DebugAddWorldQuad(primitive.m_duration, primitive.m_corners[0], primitive.m_corners[1], primitive.m_corners[2], primitive.m_corners[3], primitive.m_startColor, primitive.m_endColor, primitive.m_mode);
+			break;
+		case SnapshotDebugShape::WORLD_WIRE_QUAD:
+			DebugAddWorldWireQuad(primitive.m_duration, primitive.m_corners[0], primitive.m_corners[1], primitive.m_corners[2], primitive.m_corners[3], primitive.m_startColor, primitive.m_endColor, primitive.m_mode);
+			break;
+		}
+	}
+}
+
+void RenderSnapshot::AddDebugWorldLine(const Mat44& transform, float length, float radius, int numSides, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
+{
+	SnapshotDebugPrimitive primitive;
+	primitive.m_shape = SnapshotDebugShape::WORLD_LINE;
+	primitive.m_transform = transform;
+	primitive.m_length = length;
+	primitive.m_radius = radius;
+	primitive.m_numSides = numSides;
+	primitive.m_duration = duration;
+	primitive.m_startColor = startColor;
+	primitive.m_endColor = endColor;
+	primitive.m_mode = mode;
+
+	std::lock_guard<std::mutex> lock(m_debugPrimitiveMutex);
+	m_debugPrimitives.push_back(primitive);
+}
+
+void RenderSnapshot::AddDebugWorld3DRing(const Vec3& center, float radius, int numSides, float thickness, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
+{
+	SnapshotDebugPrimitive primitive;
+	primitive.m_shape = SnapshotDebugShape::WORLD_RING;
+	primitive.m_position = center;
+	primitive.m_radius = radius;
+	primitive.m_numSides = numSides;
+	primitive.m_thickness = thickness;
+	primitive.m_duration = duration;
+	primitive.m_startColor = startColor;
+	primitive.m_endColor = endColor;
+	primitive.m_mode = mode;
+
+	std::lock_guard<std::mutex> lock(m_debugPrimitiveMutex);
+	m_debugPrimitives.push_back(primitive);
+}
+
+void RenderSnapshot::AddDebugWorld3DTriangle(const Mat44& transform, const Vec3& forward, float height, float reach, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode, bool isWireframe)
+{
+	SnapshotDebugPrimitive primitive;
+	primitive.m_shape = isWireframe ? SnapshotDebugShape::WORLD_WIRE_TRIANGLE : SnapshotDebugShape::WORLD_TRIANGLE;
+	primitive.m_transform = transform;
+	primitive.m_position = forward;
+	primitive.m_radius = height;
+	primitive.m_length = reach;
+	primitive.m_duration = duration;
+	primitive.m_startColor = startColor;
+	primitive.m_endColor = endColor;
+	primitive.m_mode = mode;
+
+	std::lock_guard<std::mutex> lock(m_debugPrimitiveMutex);
+	m_debugPrimitives.push_back(primitive);
+}
+
+void RenderSnapshot::AddDebugWorldQuad(float duration, const Vec3& bottomLeft, const Vec3& bottomRight, const Vec3& topRight, const Vec3& topLeft, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode, bool isWireframe)
+{
+	SnapshotDebugPrimitive primitive;
+	primitive.m_shape = isWireframe ? SnapshotDebugShape::WORLD_WIRE_QUAD : SnapshotDebugShape::WORLD_QUAD;
+	primitive.m_corners[0] = bottomLeft;
+	primitive.m_corners[1] = bottomRight;
+	primitive.m_corners[2] = topRight;
+	primitive.m_corners[3] = topLeft;
+	primitive.m_duration = duration;
+	primitive.m_startColor = startColor;
+	primitive.m_endColor = endColor;
+	primitive.m_mode = mode;
+
+	std::lock_guard<std::mutex> lock(m_debugPrimitiveMutex);
+	m_debugPrimitives.push_back(primitive);
+}
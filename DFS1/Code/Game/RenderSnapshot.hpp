@@ -0,0 +1,97 @@
+#pragma once
+#include "Game/ActorType.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Renderer/DebugRenderer.hpp"
+#include <vector>
+#include <string>
+#include <mutex>
+
+class Actor;
+
+// What one visible actor looks like this frame. The actor pointer is only used for its GPU buffers, which
+// never change after spawning; destroyed actors are kept alive until no snapshot can still point at them
+struct ActorRenderState
+{
+	const Actor* m_actor = nullptr;
+	ActorType m_type = ActorType::UNKNOWN;
+	Mat44 m_modelMatrix;
+	Rgba8 m_color = Rgba8::WHITE;
+	Rgba8 m_eyeColor = Rgba8::WHITE;
+};
+
+enum class SnapshotDebugShape
+{
+	WORLD_LINE,
+	WORLD_RING,
+	WORLD_TRIANGLE,
+	WORLD_WIRE_TRIANGLE,
+	WORLD_QUAD,
+	WORLD_WIRE_QUAD
+};
+
+// A debug draw recorded by the simulation, handed to the debug renderer on the main thread
+struct SnapshotDebugPrimitive
+{
+	SnapshotDebugShape m_shape = SnapshotDebugShape::WORLD_LINE;
+	Mat44 m_transform;
+	Vec3 m_position; // Ring center, or the forward direction of a triangle
+	Vec3 m_corners[4];
+	float m_length = 0.f; // Line length, or triangle reach
+	float m_radius = 0.f; // Line and ring radius, or triangle height
+	float m_thickness = 0.f;
+	int m_numSides = 0;
+	float m_duration = 0.f;
+	Rgba8 m_startColor = Rgba8::WHITE;
+	Rgba8 m_endColor = Rgba8::WHITE;
+	DebugRenderMode m_mode = DebugRenderMode::ALWAYS;
+};
+
+struct SnapshotScreenText
+{
+	std::string m_text;
+	float m_offsetFromTop = 0.f;
+	Rgba8 m_color = Rgba8::WHITE;
+};
+
+// Everything the render side needs from one simulated frame. The simulation fills one of these and publishes
+// it, after that it is read only, so rendering never has to look at actors or map state the simulation
+// might be changing at the same time
+class RenderSnapshot
+{
+public:
+	RenderSnapshot() = default;
+	~RenderSnapshot() = default;
+
+	void Clear();
+	void SubmitDebugPrimitives() const;
+
+	// Safe to call from several threads while the snapshot is being built
+	void AddDebugWorldLine(const Mat44& transform, float length, float radius, int numSides, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode);
+	void AddDebugWorld3DRing(const Vec3& center, float radius, int numSides, float thickness, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode);
+	void AddDebugWorld3DTriangle(const Mat44& transform, const Vec3& forward, float height, float reach, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode, bool isWireframe);
+	void AddDebugWorldQuad(float duration, const Vec3& bottomLeft, const Vec3& bottomRight, const Vec3& topRight, const Vec3& topLeft, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode, bool isWireframe);
+
+public:
+	std::vector<ActorRenderState> m_actors;
+	std::vector<SnapshotScreenText> m_debugOverlayLines;
+
+	// HUD
+	float m_gameTime = 0.f;
+	bool m_didAddTime = false;
+	bool m_hasPlayerReachedGoal = false;
+	bool m_hasPlayerActor = false;
+	int m_playerHealth = 0;
+	int m_numEnemies = 0;
+
+	// Camera follows the player actor's blended transform
+	Vec3 m_playerPosition;
+	EulerAngles m_playerOrientation;
+	float m_playerEyeHeight = 0.f;
+
+private:
+	std::vector<SnapshotDebugPrimitive> m_debugPrimitives;
+	std::mutex m_debugPrimitiveMutex;
+};
@@ -0,0 +1,68 @@
+#include "Game/SimulationThread.hpp"
+#include "Game/Map.hpp"
+
+SimulationThread::SimulationThread(Map* map)
+	:m_map(map)
+{
+	m_thread = std::thread(&SimulationThread::ThreadMain, this);
+}
+
+SimulationThread::~SimulationThread()
+{
+	WaitForFrame();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isQuitting = true;
+	}
+	m_frameCondition.notify_all();
+	m_thread.join();
+}
+
+void SimulationThread::StartFrame(float frameDeltaSeconds)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_frameDeltaSeconds = frameDeltaSeconds;
+		m_isFrameRequested = true;
+		m_isFrameInFlight = true;
+	}
+	m_frameCondition.notify_all();
+}
+
+void SimulationThread::WaitForFrame()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_frameCondition.wait(lock, [this]() { return !m_isFrameInFlight; });
+}
+
+bool SimulationThread::IsFrameInFlight() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_isFrameInFlight;
+}
+
+void SimulationThread::ThreadMain()
+{
+	for (;;)
+	{
+		float frameDeltaSeconds = 0.f;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_frameCondition.wait(lock, [this]() { return m_isFrameRequested || m_isQuitting; });
+			if (m_isQuitting)
+			{
+				return;
+			}
+			m_isFrameRequested = false;
+			frameDeltaSeconds = m_frameDeltaSeconds;
+		}
+
+		m_map->RunSimulationFrame(frameDeltaSeconds);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isFrameInFlight = false;
+		}
+		m_frameCondition.notify_all();
+	}
+}
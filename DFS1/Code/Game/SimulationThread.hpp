@@ -0,0 +1,33 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class Map;
+
+// Runs a map's simulation frames on a thread of its own. The main thread hands over one frame at a time and
+// renders the last published snapshot while that frame runs, then waits for it before touching the map
+// again, so input, console commands and the engine's frame begin/end never overlap the simulation.
+class SimulationThread
+{
+public:
+	explicit SimulationThread(Map* map);
+	~SimulationThread();
+
+	void StartFrame(float frameDeltaSeconds);
+	void WaitForFrame();
+	bool IsFrameInFlight() const;
+
+private:
+	void ThreadMain();
+
+private:
+	Map* m_map = nullptr;
+	std::thread m_thread;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_frameCondition;
+	bool m_isFrameRequested = false;
+	bool m_isFrameInFlight = false;
+	bool m_isQuitting = false;
+	float m_frameDeltaSeconds = 0.f;
+};
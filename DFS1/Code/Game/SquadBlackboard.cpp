@@ -0,0 +1,95 @@
+#include "Game/SquadBlackboard.hpp"
+#include "Game/Map.hpp"
+#include "Game/Actor.hpp"
+#include "Game/AIActor.hpp"
+
+void SquadBlackboard::Update(Map* map, float currentTime)
+{
+	m_numSeeingPlayer = 0;
+	m_numChasersSeeingPlayer = 0;
+
+	Actor* playerActor = map->GetPlayerActor();
+	if (playerActor == nullptr)
+	{
+		return;
+	}
+
+	for (Actor* actor : map->m_actors)
+	{
+		if (actor == nullptr || !actor->m_isAI)
+		{
+			continue;
+		}
+
+		AIActor* aiController = actor->GetAiController();
+		if (aiController == nullptr || !aiController->CanSeeTarget(playerActor))
+		{
+			continue;
+		}
+
+		m_numSeeingPlayer++;
+		if (aiController->m_currentState == AIState::CHASE)
+		{
+			m_numChasersSeeingPlayer++;
+		}
+	}
+
+	if (m_numSeeingPlayer > 0)
+	{
+		m_hasSeenPlayer = true;
+		m_lastSeenPosition = playerActor->m_position;
+		m_lastSeenTime = currentTime;
+	}
+}
+
+void SquadBlackboard::RaiseGroupAlert(const Vec3& targetPosition, float currentTime)
+{
+	// Every raise gets a new serial so AIs that already answered an earlier alert still react to this one
+	m_alertState = SquadAlertState::ALERTED;
+	m_alertSerial++;
+	m_hasSeenPlayer = true;
+	m_lastSeenPosition = targetPosition;
+	m_lastSeenTime = currentTime;
+}
+
+void SquadBlackboard::StandDown()
+{
+	m_alertState = SquadAlertState::CALM;
+	m_numSeeingPlayer = 0;
+	m_numChasersSeeingPlayer = 0;
+}
+
+int SquadBlackboard::GetNumSeeingPlayer() const
+{
+	return m_numSeeingPlayer;
+}
+
+int SquadBlackboard::GetNumChasersSeeingPlayer() const
+{
+	return m_numChasersSeeingPlayer;
+}
+
+bool SquadBlackboard::HasSeenPlayer() const
+{
+	return m_hasSeenPlayer;
+}
+
+Vec3 SquadBlackboard::GetLastSeenPosition() const
+{
+	return m_lastSeenPosition;
+}
+
+float SquadBlackboard::GetLastSeenTime() const
+{
+	return m_lastSeenTime;
+}
+
+SquadAlertState SquadBlackboard::GetAlertState() const
+{
+	return m_alertState;
+}
+
+unsigned int SquadBlackboard::GetAlertSerial() const
+{
+	return m_alertSerial;
+}
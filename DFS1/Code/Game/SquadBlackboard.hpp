@@ -0,0 +1,43 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+
+class Map;
+
+enum class SquadAlertState
+{
+	CALM,
+	ALERTED
+};
+
+// What the map's AI squad knows about the player, gathered once per frame right after perception.
+// The chase logic reads these aggregates instead of asking every other AI for its line of sight,
+// and alerts are posted here for each AI to pick up on its own update instead of being pushed to all of them.
+class SquadBlackboard
+{
+public:
+	SquadBlackboard() = default;
+	~SquadBlackboard() = default;
+
+	void Update(Map* map, float currentTime);
+	void RaiseGroupAlert(const Vec3& targetPosition, float currentTime);
+	void StandDown();
+
+	int GetNumSeeingPlayer() const;
+	int GetNumChasersSeeingPlayer() const;
+	bool HasSeenPlayer() const;
+	Vec3 GetLastSeenPosition() const;
+	float GetLastSeenTime() const;
+
+	SquadAlertState GetAlertState() const;
+	unsigned int GetAlertSerial() const;
+
+private:
+	int m_numSeeingPlayer = 0;
+	int m_numChasersSeeingPlayer = 0;
+	bool m_hasSeenPlayer = false;
+	Vec3 m_lastSeenPosition = Vec3::ZERO;
+	float m_lastSeenTime = 0.f;
+
+	SquadAlertState m_alertState = SquadAlertState::CALM;
+	unsigned int m_alertSerial = 0;
+};
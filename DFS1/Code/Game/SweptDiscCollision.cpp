@@ -0,0 +1,329 @@
+#include "Game/SweptDiscCollision.hpp"
+#include "Game/WallDistanceField.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const int MAX_SLIDES = 4;
+	const float CONTACT_SKIN = 0.001f; // Stopping this far off a wall keeps the next trace from starting inside it
+	const float VALIDATION_TOLERANCE = 0.002f;
+	const float VALIDATION_SAMPLE_SPACING = 0.01f;
+}
+
+SweptDiscCollision::SweptDiscCollision(const IntVec2& dimensions, const std::vector<unsigned char>& solidTiles, const WallDistanceField& wallDistance)
+	:m_dimensions(dimensions), m_solidTiles(solidTiles), m_wallDistance(wallDistance)
+{
+}
+
+DiscSweepResult SweptDiscCollision::SweepAndSlide(const Vec2& start, const Vec2& displacement, float radius) const
+{
+	DiscSweepResult result;
+	result.m_position = start;
+
+	Vec2 remaining = displacement;
+	for (int slideIndex = 0; slideIndex <= MAX_SLIDES; slideIndex++)
+	{
+		if (remaining.GetLengthSquared() < 1e-12f)
+		{
+			break;
+		}
+
+		Vec2 wallNormal;
+		float timeOfImpact = GetTimeOfImpact(result.m_position, remaining, radius, wallNormal);
+		if (timeOfImpact >= 1.f)
+		{
+			result.m_position += remaining;
+			break;
+		}
+
+		result.m_position += remaining * timeOfImpact + wallNormal * CONTACT_SKIN;
+		result.m_didHitWall = true;
+		result.m_wallNormal = wallNormal;
+		result.m_numSlides++;
+
+		// Whatever was left of the move carries on along the wall
+		remaining = remaining * (1.f - timeOfImpact);
+		remaining -= wallNormal * DotProduct2D(remaining, wallNormal);
+	}
+
+	// Float error can still leave the disc grazing a tile, the same push out the discrete mode uses settles it
+	PushOutOfWalls(result.m_position, radius);
+	return result;
+}
+
+float SweptDiscCollision::GetTimeOfImpact(const Vec2& start, const Vec2& displacement, float radius, Vec2& outWallNormal) const
+{
+	float moveLength = displacement.GetLength();
+
+	// Every solid tile is at least (distance - 1) tiles away from any point in the start tile
+	int startTileX = RoundDownToInt(start.x);
+	int startTileY = RoundDownToInt(start.y);
+	if (startTileX >= 0 && startTileY >= 0 && startTileX < m_dimensions.x && startTileY < m_dimensions.y)
+	{
+		if (static_cast<float>(m_wallDistance.GetDistance(startTileX, startTileY) - 1) > moveLength + radius)
+		{
+			return 1.f;
+		}
+	}
+
+	// Only tiles under the box swept by the disc can be touched
+	Vec2 end = start + displacement;
+	int minTileX = std::max(RoundDownToInt(std::min(start.x, end.x) - radius), 0);
+	int minTileY = std::max(RoundDownToInt(std::min(start.y, end.y) - radius), 0);
+	int maxTileX = std::min(RoundDownToInt(std::max(start.x, end.x) + radius), m_dimensions.x - 1);
+	int maxTileY = std::min(RoundDownToInt(std::max(start.y, end.y) + radius), m_dimensions.y - 1);
+
+	float firstImpact = 1.f;
+	for (int tileY = minTileY; tileY <= maxTileY; tileY++)
+	{
+		for (int tileX = minTileX; tileX <= maxTileX; tileX++)
+		{
+			if (!IsSolidTile(tileX, tileY))
+			{
+				continue;
+			}
+
+			Vec2 tileNormal;
+			float tileImpact = GetTimeOfImpactWithTile(start, displacement, radius, tileX, tileY, tileNormal);
+			if (tileImpact < firstImpact)
+			{
+				firstImpact = tileImpact;
+				outWallNormal = tileNormal;
+			}
+		}
+	}
+	return firstImpact;
+}
+
+float SweptDiscCollision::GetTimeOfImpactWithTile(const Vec2& start, const Vec2& displacement, float radius, int tileX, int tileY, Vec2& outWallNormal) const
+{
+	Vec2 tileMins(static_cast<float>(tileX), static_cast<float>(tileY));
+	Vec2 tileMaxs(static_cast<float>(tileX + 1), static_cast<float>(tileY + 1));
+
+	// A disc already overlapping the tile only counts as hitting it when it moves further in
+	Vec2 nearestPoint(GetClamped(start.x, tileMins.x, tileMaxs.x), GetClamped(start.y, tileMins.y, tileMaxs.y));
+	Vec2 awayFromTile = start - nearestPoint;
+	float distanceSquared = awayFromTile.GetLengthSquared();
+	if (distanceSquared < radius * radius)
+	{
+		if (distanceSquared > 0.f && DotProduct2D(displacement, awayFromTile) < 0.f)
+		{
+			outWallNormal = awayFromTile.GetNormalized();
+			return 0.f;
+		}
+		return 1.f;
+	}
+
+	// Ray against the tile grown by the radius on every side
+	float startCoords[2] = { start.x, start.y };
+	float moveCoords[2] = { displacement.x, displacement.y };
+	float grownMins[2] = { tileMins.x - radius, tileMins.y - radius };
+	float grownMaxs[2] = { tileMaxs.x + radius, tileMaxs.y + radius };
+	float entryTime = 0.f;
+	float exitTime = 1.f;
+	int entryAxis = -1;
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (fabsf(moveCoords[axis]) < 1e-9f)
+		{
+			if (startCoords[axis] < grownMins[axis] || startCoords[axis] > grownMaxs[axis])
+			{
+				return 1.f;
+			}
+			continue;
+		}
+
+		float nearTime = (grownMins[axis] - startCoords[axis]) / moveCoords[axis];
+		float farTime = (grownMaxs[axis] - startCoords[axis]) / moveCoords[axis];
+		if (nearTime > farTime)
+		{
+			std::swap(nearTime, farTime);
+		}
+		if (nearTime > entryTime)
+		{
+			entryTime = nearTime;
+			entryAxis = axis;
+		}
+		exitTime = std::min(exitTime, farTime);
+		if (entryTime > exitTime)
+		{
+			return 1.f;
+		}
+	}
+
+	// Entering the grown box beside a face is a hit on that face, entering it past a corner is only a hit if
+	// the corner's rounded edge is crossed too
+	Vec2 entryPoint = start + displacement * entryTime;
+	bool isPastX = entryPoint.x < tileMins.x || entryPoint.x > tileMaxs.x;
+	bool isPastY = entryPoint.y < tileMins.y || entryPoint.y > tileMaxs.y;
+	if (!(isPastX && isPastY))
+	{
+		if (entryAxis < 0)
+		{
+			return 1.f;
+		}
+		outWallNormal = entryAxis == 0 ? Vec2(moveCoords[0] > 0.f ? -1.f : 1.f, 0.f) : Vec2(0.f, moveCoords[1] > 0.f ? -1.f : 1.f);
+		return entryTime;
+	}
+
+	Vec2 corner(entryPoint.x < tileMins.x ? tileMins.x : tileMaxs.x, entryPoint.y < tileMins.y ? tileMins.y : tileMaxs.y);
+	Vec2 cornerToStart = start - corner;
+	float a = displacement.GetLengthSquared();
+	float b = 2.f * DotProduct2D(cornerToStart, displacement);
+	float c = cornerToStart.GetLengthSquared() - radius * radius;
+	float discriminant = b * b - 4.f * a * c;
+	if (discriminant < 0.f)
+	{
+		return 1.f;
+	}
+	float cornerTime = (-b - sqrtf(discriminant)) / (2.f * a);
+	if (cornerTime < 0.f || cornerTime >= 1.f)
+	{
+		return 1.f;
+	}
+	outWallNormal = (start + displacement * cornerTime - corner).GetNormalized();
+	return cornerTime;
+}
+
+bool SweptDiscCollision::PushOutOfWalls(Vec2& position, float radius) const
+{
+	// Every tile under the disc, diagonal neighbors included
+	bool didPush = false;
+	for (int tileY = RoundDownToInt(position.y - radius); tileY <= RoundDownToInt(position.y + radius); tileY++)
+	{
+		for (int tileX = RoundDownToInt(position.x - radius); tileX <= RoundDownToInt(position.x + radius); tileX++)
+		{
+			if (IsSolidTile(tileX, tileY))
+			{
+				AABB2 tileBounds(Vec2(static_cast<float>(tileX), static_cast<float>(tileY)), Vec2(static_cast<float>(tileX + 1), static_cast<float>(tileY + 1)));
+				didPush |= PushDiscOutOfFixedAABB2D(position, radius, tileBounds);
+			}
+		}
+	}
+	return didPush;
+}
+
+float SweptDiscCollision::GetClearance(const Vec2& position, float radius) const
+{
+	float nearestDistance = radius + 1.f;
+	for (int tileY = RoundDownToInt(position.y - radius) - 1; tileY <= RoundDownToInt(position.y + radius) + 1; tileY++)
+	{
+		for (int tileX = RoundDownToInt(position.x - radius) - 1; tileX <= RoundDownToInt(position.x + radius) + 1; tileX++)
+		{
+			if (!IsSolidTile(tileX, tileY))
+			{
+				continue;
+			}
+			Vec2 nearestPoint(GetClamped(position.x, static_cast<float>(tileX), static_cast<float>(tileX + 1)), GetClamped(position.y, static_cast<float>(tileY), static_cast<float>(tileY + 1)));
+			nearestDistance = std::min(nearestDistance, (position - nearestPoint).GetLength());
+		}
+	}
+	return nearestDistance - radius;
+}
+
+bool SweptDiscCollision::IsSolidTile(int tileX, int tileY) const
+{
+	if (tileX < 0 || tileY < 0 || tileX >= m_dimensions.x || tileY >= m_dimensions.y)
+	{
+		return false;
+	}
+	return m_solidTiles[tileY * m_dimensions.x + tileX] != 0;
+}
+
+void SweptDiscCollision::RunValidation(int numTrials, std::vector<std::string>& outLines) const
+{
+	// Random discs thrown at random speeds and step lengths, up to several tiles per step. Along the traced
+	// move the disc must never sink into a wall, where the trace stops it must actually be touching one, and
+	// after sliding it must end up clear of every wall
+	int numRun = 0;
+	int numHits = 0;
+	int numSlides = 0;
+	int numWouldHavePassedThrough = 0;
+	int numPenetrations = 0;
+	int numEarlyStops = 0;
+	int numOverlappingEnds = 0;
+	std::string firstFailure;
+
+	for (int trialIndex = 0; trialIndex < numTrials; trialIndex++)
+	{
+		float radius = g_rng.RollRandomFloatInRange(0.1f, 0.45f);
+		Vec2 start;
+		bool isStartClear = false;
+		for (int attempt = 0; attempt < 100 && !isStartClear; attempt++)
+		{
+			start = Vec2(g_rng.RollRandomFloatInRange(0.f, static_cast<float>(m_dimensions.x)), g_rng.RollRandomFloatInRange(0.f, static_cast<float>(m_dimensions.y)));
+			isStartClear = GetClearance(start, radius) > 0.f;
+		}
+		if (!isStartClear)
+		{
+			continue;
+		}
+		numRun++;
+
+		float yawDegrees = g_rng.RollRandomFloatInRange(0.f, 360.f);
+		float speed = g_rng.RollRandomFloatInRange(0.f, 30.f);
+		float deltaSeconds = g_rng.RollRandomFloatInRange(1.f / 240.f, 1.f / 8.f);
+		Vec2 displacement = Vec2(CosDegrees(yawDegrees), SinDegrees(yawDegrees)) * (speed * deltaSeconds);
+		float moveLength = displacement.GetLength();
+
+		Vec2 wallNormal;
+		float timeOfImpact = GetTimeOfImpact(start, displacement, radius, wallNormal);
+		int numSamples = static_cast<int>(ceilf(moveLength / VALIDATION_SAMPLE_SPACING)) + 1;
+		bool didPenetrate = false;
+		bool didCenterEnterWall = false;
+		for (int sampleIndex = 0; sampleIndex <= numSamples; sampleIndex++)
+		{
+			float fraction = static_cast<float>(sampleIndex) / static_cast<float>(numSamples);
+			Vec2 samplePosition = start + displacement * fraction;
+			if (fraction <= timeOfImpact && GetClearance(samplePosition, radius) < -VALIDATION_TOLERANCE)
+			{
+				didPenetrate = true;
+			}
+			didCenterEnterWall |= IsSolidTile(RoundDownToInt(samplePosition.x), RoundDownToInt(samplePosition.y));
+		}
+		numWouldHavePassedThrough += didCenterEnterWall ? 1 : 0;
+
+		bool didStopEarly = timeOfImpact < 1.f && GetClearance(start + displacement * timeOfImpact, radius) > VALIDATION_TOLERANCE;
+		DiscSweepResult sweep = SweepAndSlide(start, displacement, radius);
+		bool isEndOverlapping = GetClearance(sweep.m_position, radius) < -VALIDATION_TOLERANCE;
+		numHits += sweep.m_didHitWall ? 1 : 0;
+		numSlides += sweep.m_numSlides;
+		numPenetrations += didPenetrate ? 1 : 0;
+		numEarlyStops += didStopEarly ? 1 : 0;
+		numOverlappingEnds += isEndOverlapping ? 1 : 0;
+
+		if (firstFailure.empty() && (didPenetrate || didStopEarly || isEndOverlapping))
+		{
+			firstFailure = Stringf("First failure: start (%.4f, %.4f), move (%.4f, %.4f), radius %.3f, impact at %.4f", start.x, start.y, displacement.x, displacement.y, radius, timeOfImpact);
+		}
+	}
+
+	outLines.push_back(Stringf("Wall sweep on %dx%d tiles: %d trials, %d hit a wall, %d slides, %d would have gone into a wall without sweeping", m_dimensions.x, m_dimensions.y, numRun, numHits, numSlides, numWouldHavePassedThrough));
+	outLines.push_back(Stringf("  %d sank into a wall, %d stopped short of one, %d ended overlapping one", numPenetrations, numEarlyStops, numOverlappingEnds));
+	if (!firstFailure.empty())
+	{
+		outLines.push_back(std::string("  ") + firstFailure);
+	}
+}
+
+STATIC void SweptDiscCollision::RunRandomGridValidation(int numTrials, std::vector<std::string>& outLines)
+{
+	// Scattered single tiles give far more exposed corners than any maze does
+	IntVec2 dimensions(48, 48);
+	std::vector<unsigned char> solidTiles(dimensions.x * dimensions.y, 0);
+	for (unsigned char& solidTile : solidTiles)
+	{
+		solidTile = g_rng.RollRandomFloatInRange(0.f, 1.f) < 0.3f ? 1 : 0;
+	}
+
+	WallDistanceField wallDistance;
+	wallDistance.Build(dimensions, solidTiles);
+	SweptDiscCollision randomGrid(dimensions, solidTiles, wallDistance);
+	randomGrid.RunValidation(numTrials, outLines);
+}
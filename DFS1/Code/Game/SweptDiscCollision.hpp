@@ -0,0 +1,43 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include <vector>
+#include <string>
+
+class WallDistanceField;
+
+struct DiscSweepResult
+{
+	Vec2 m_position;
+	bool m_didHitWall = false;
+	Vec2 m_wallNormal; // Of the last wall touched
+	int m_numSlides = 0;
+};
+
+// Moves a disc through the solid tiles of a grid without passing through any of them, however far it goes in
+// one step. A move is traced as a ray against every solid tile it could reach, each grown by the disc's radius
+// into a rounded box, so the disc stops at the first wall it would touch, tile corners included. What is left
+// of the move then slides along that wall. The wall distance field rules out most moves before any tile is
+// looked at. Tiles outside the grid are open, the same as everywhere else in Map.
+class SweptDiscCollision
+{
+public:
+	SweptDiscCollision(const IntVec2& dimensions, const std::vector<unsigned char>& solidTiles, const WallDistanceField& wallDistance);
+
+	DiscSweepResult SweepAndSlide(const Vec2& start, const Vec2& displacement, float radius) const;
+	float GetTimeOfImpact(const Vec2& start, const Vec2& displacement, float radius, Vec2& outWallNormal) const; // 1 when nothing is hit
+	bool PushOutOfWalls(Vec2& position, float radius) const;
+	float GetClearance(const Vec2& position, float radius) const; // Gap to the nearest wall within a tile, negative when overlapping
+
+	void RunValidation(int numTrials, std::vector<std::string>& outLines) const;
+	static void RunRandomGridValidation(int numTrials, std::vector<std::string>& outLines);
+
+private:
+	bool IsSolidTile(int tileX, int tileY) const;
+	float GetTimeOfImpactWithTile(const Vec2& start, const Vec2& displacement, float radius, int tileX, int tileY, Vec2& outWallNormal) const;
+
+private:
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	const std::vector<unsigned char>& m_solidTiles;
+	const WallDistanceField& m_wallDistance;
+};
@@ -0,0 +1,345 @@
+#include "Game/TileVisibilitySet.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	constexpr int MAX_POLYGON_VERTS = 64;
+
+	// Convex set of lines y = slope * x + intercept, kept as a polygon in (slope, intercept) space
+	struct LinePolygon
+	{
+		int m_numVerts = 0;
+		double m_slopes[MAX_POLYGON_VERTS];
+		double m_intercepts[MAX_POLYGON_VERTS];
+	};
+
+	// Keeps the part of the polygon where a * slope + b * intercept <= d. Points on the edge count as inside
+	// so grazing lines are kept, which errs on the visible side
+	bool ClipLinePolygon(const LinePolygon& polygon, double a, double b, double d, LinePolygon& outPolygon)
+	{
+		constexpr double EPSILON = 1e-9;
+		outPolygon.m_numVerts = 0;
+		for (int vertIndex = 0; vertIndex < polygon.m_numVerts; vertIndex++)
+		{
+			int nextIndex = (vertIndex + 1) % polygon.m_numVerts;
+			double currentValue = a * polygon.m_slopes[vertIndex] + b * polygon.m_intercepts[vertIndex] - d;
+			double nextValue = a * polygon.m_slopes[nextIndex] + b * polygon.m_intercepts[nextIndex] - d;
+			bool isCurrentInside = currentValue <= EPSILON;
+			bool isNextInside = nextValue <= EPSILON;
+
+			if (isCurrentInside)
+			{
+				outPolygon.m_slopes[outPolygon.m_numVerts] = polygon.m_slopes[vertIndex];
+				outPolygon.m_intercepts[outPolygon.m_numVerts] = polygon.m_intercepts[vertIndex];
+				outPolygon.m_numVerts++;
+			}
+			if (isCurrentInside != isNextInside)
+			{
+				double t = currentValue / (currentValue - nextValue);
+				outPolygon.m_slopes[outPolygon.m_numVerts] = polygon.m_slopes[vertIndex] + t * (polygon.m_slopes[nextIndex] - polygon.m_slopes[vertIndex]);
+				outPolygon.m_intercepts[outPolygon.m_numVerts] = polygon.m_intercepts[vertIndex] + t * (polygon.m_intercepts[nextIndex] - polygon.m_intercepts[vertIndex]);
+				outPolygon.m_numVerts++;
+			}
+		}
+		return outPolygon.m_numVerts > 0;
+	}
+
+	// Every column strictly between A and B is crossed completely, so the line has to fit inside one free
+	// run of each. The columns holding A and B are not checked, which can only ever add visibility
+	template <typename IsSolidFunc>
+	bool CanFitThroughColumns(const IsSolidFunc& isSolid, const LinePolygon& polygon, int column, int deltaX, int deltaY)
+	{
+		if (column >= deltaX)
+		{
+			return true;
+		}
+
+		// Two clips per column add at most two vertices, bail out conservatively before running out of room
+		if (polygon.m_numVerts + 2 > MAX_POLYGON_VERTS)
+		{
+			return true;
+		}
+
+		// Only rows some remaining line actually reaches in this column need to be looked at
+		double lowestY = polygon.m_slopes[0] * column + polygon.m_intercepts[0];
+		double highestY = polygon.m_slopes[0] * (column + 1) + polygon.m_intercepts[0];
+		for (int vertIndex = 1; vertIndex < polygon.m_numVerts; vertIndex++)
+		{
+			lowestY = std::min(lowestY, polygon.m_slopes[vertIndex] * column + polygon.m_intercepts[vertIndex]);
+			highestY = std::max(highestY, polygon.m_slopes[vertIndex] * (column + 1) + polygon.m_intercepts[vertIndex]);
+		}
+		int row = std::max(0, static_cast<int>(floor(lowestY)));
+		int lastRow = std::min(deltaY, static_cast<int>(floor(highestY)));
+
+		while (row <= lastRow)
+		{
+			if (isSolid(column, row))
+			{
+				row++;
+				continue;
+			}
+
+			// Walk back to where the run really starts, the clip below needs its true bottom
+			int runStart = row;
+			while (runStart > 0 && !isSolid(column, runStart - 1))
+			{
+				runStart--;
+			}
+			while (row <= deltaY && !isSolid(column, row))
+			{
+				row++;
+			}
+
+			LinePolygon aboveRunBottom;
+			LinePolygon insideRun;
+			if (ClipLinePolygon(polygon, -static_cast<double>(column), -1.0, -static_cast<double>(runStart), aboveRunBottom) &&
+				ClipLinePolygon(aboveRunBottom, static_cast<double>(column + 1), 1.0, static_cast<double>(row), insideRun) &&
+				CanFitThroughColumns(isSolid, insideRun, column + 1, deltaX, deltaY))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// A sits at tile (0, 0) and B at (deltaX, deltaY) with deltaX >= 2 and deltaY >= 0, only rising lines are searched
+	template <typename IsSolidFunc>
+	bool CanSeeAlongRisingLines(const IsSolidFunc& isSolid, int deltaX, int deltaY)
+	{
+		double maxSlope = static_cast<double>(deltaY + 2);
+		double minIntercept = -maxSlope * static_cast<double>(deltaX + 1) - 1.0;
+		LinePolygon polygon;
+		polygon.m_numVerts = 4;
+		polygon.m_slopes[0] = 0.0;
+		polygon.m_intercepts[0] = minIntercept;
+		polygon.m_slopes[1] = maxSlope;
+		polygon.m_intercepts[1] = minIntercept;
+		polygon.m_slopes[2] = maxSlope;
+		polygon.m_intercepts[2] = 2.0;
+		polygon.m_slopes[3] = 0.0;
+		polygon.m_intercepts[3] = 2.0;
+
+		// For a rising line, passing through a square comes down to one half plane per corner
+		LinePolygon aboveBottomOfA;
+		LinePolygon throughA;
+		LinePolygon aboveBottomOfB;
+		LinePolygon throughB;
+		if (!ClipLinePolygon(polygon, -1.0, -1.0, 0.0, aboveBottomOfA)) return false;
+		if (!ClipLinePolygon(aboveBottomOfA, 0.0, 1.0, 1.0, throughA)) return false;
+		if (!ClipLinePolygon(throughA, -static_cast<double>(deltaX + 1), -1.0, -static_cast<double>(deltaY), aboveBottomOfB)) return false;
+		if (!ClipLinePolygon(aboveBottomOfB, static_cast<double>(deltaX), 1.0, static_cast<double>(deltaY + 1), throughB)) return false;
+
+		return CanFitThroughColumns(isSolid, throughB, 1, deltaX, deltaY);
+	}
+}
+
+void TileVisibilitySet::Build(const IntVec2& dimensions, const std::vector<unsigned char>& solidTiles, int radius)
+{
+	m_dimensions = dimensions;
+	m_radius = radius;
+	m_windowWidth = 2 * radius + 1;
+	m_wordsPerTile = (m_windowWidth * m_windowWidth + 63) / 64;
+	m_bits.assign(static_cast<size_t>(dimensions.x) * dimensions.y * m_wordsPerTile, 0);
+
+	BuildRowsInRegion(solidTiles, IntVec2(0, 0), IntVec2(dimensions.x - 1, dimensions.y - 1));
+}
+
+void TileVisibilitySet::RebuildAroundTile(const std::vector<unsigned char>& solidTiles, const IntVec2& tileCoords)
+{
+	// Any sight line crossing the edited tile starts within the window radius of it
+	IntVec2 regionMins = IntVec2(std::max(tileCoords.x - m_radius, 0), std::max(tileCoords.y - m_radius, 0));
+	IntVec2 regionMaxs = IntVec2(std::min(tileCoords.x + m_radius, m_dimensions.x - 1), std::min(tileCoords.y + m_radius, m_dimensions.y - 1));
+
+	for (int tileY = regionMins.y; tileY <= regionMaxs.y; tileY++)
+	{
+		for (int tileX = regionMins.x; tileX <= regionMaxs.x; tileX++)
+		{
+			uint64_t* tileBits = &m_bits[static_cast<size_t>(tileX + tileY * m_dimensions.x) * m_wordsPerTile];
+			std::fill(tileBits, tileBits + m_wordsPerTile, 0ull);
+		}
+	}
+
+	BuildRowsInRegion(solidTiles, regionMins, regionMaxs);
+}
+
+void TileVisibilitySet::BuildRowsInRegion(const std::vector<unsigned char>& solidTiles, const IntVec2& regionMins, const IntVec2& regionMaxs)
+{
+	for (int fromY = regionMins.y; fromY <= regionMaxs.y; fromY++)
+	{
+		for (int fromX = regionMins.x; fromX <= regionMaxs.x; fromX++)
+		{
+			IntVec2 fromTile = IntVec2(fromX, fromY);
+			bool isFromSolid = solidTiles[fromX + fromY * m_dimensions.x] != 0;
+
+			for (int offsetY = -m_radius; offsetY <= m_radius; offsetY++)
+			{
+				for (int offsetX = -m_radius; offsetX <= m_radius; offsetX++)
+				{
+					IntVec2 toTile = IntVec2(fromX + offsetX, fromY + offsetY);
+					if (toTile.x < 0 || toTile.y < 0 || toTile.x >= m_dimensions.x || toTile.y >= m_dimensions.y)
+					{
+						continue;
+					}
+
+					// Actors pushed into a wall are left to the exact raycast
+					bool isToSolid = solidTiles[toTile.x + toTile.y * m_dimensions.x] != 0;
+					if (isFromSolid || isToSolid)
+					{
+						SetBit(fromTile, toTile);
+						continue;
+					}
+
+					// Visibility is symmetric, so pairs already solved from the other side are copied over. Rows
+					// outside the region were left untouched and are still valid since their sight lines miss it
+					int toIndex = toTile.x + toTile.y * m_dimensions.x;
+					int fromIndex = fromX + fromY * m_dimensions.x;
+					bool isToInRegion = toTile.x >= regionMins.x && toTile.x <= regionMaxs.x && toTile.y >= regionMins.y && toTile.y <= regionMaxs.y;
+					bool isOtherSideBuilt = !isToInRegion || toIndex < fromIndex;
+
+					if (isOtherSideBuilt)
+					{
+						if (IsPotentiallyVisible(toTile, fromTile))
+						{
+							SetBit(fromTile, toTile);
+						}
+					}
+					else if (CanTilesSeeEachOther(solidTiles, fromTile, toTile))
+					{
+						SetBit(fromTile, toTile);
+					}
+				}
+			}
+		}
+	}
+}
+
+bool TileVisibilitySet::CanTilesSeeEachOther(const std::vector<unsigned char>& solidTiles, const IntVec2& tileA, const IntVec2& tileB) const
+{
+	IntVec2 delta = tileB - tileA;
+	if (abs(delta.x) <= 1 && abs(delta.y) <= 1)
+	{
+		return true;
+	}
+
+	// Most open pairs are settled by the line between the tile centers
+	if (IsCenterLineClear(solidTiles, tileA, tileB))
+	{
+		return true;
+	}
+
+	// Exact region to region test: B is visible if any segment from a point in A to a point in B stays clear.
+	// Mirror and transpose the pair so lines run mostly along +x and rise. Mirroring whole tiles is an
+	// isometry so the answer is unchanged
+	bool isTransposed = abs(delta.y) > abs(delta.x);
+	int dominantDelta = isTransposed ? delta.y : delta.x;
+	int minorDelta = isTransposed ? delta.x : delta.y;
+	int dominantStep = (dominantDelta > 0) ? 1 : -1;
+
+	for (int minorStep = -1; minorStep <= 1; minorStep += 2)
+	{
+		// Maps the local frame (A at the origin, B at +x, lines rising) back onto map tiles
+		auto IsLocalTileSolid = [&](int localX, int localY)
+			{
+				int alongDominant = localX * dominantStep;
+				int alongMinor = localY * minorStep;
+				int tileX = tileA.x + (isTransposed ? alongMinor : alongDominant);
+				int tileY = tileA.y + (isTransposed ? alongDominant : alongMinor);
+
+				if (tileX < 0 || tileY < 0 || tileX >= m_dimensions.x || tileY >= m_dimensions.y)
+				{
+					return false;
+				}
+				return solidTiles[tileX + tileY * m_dimensions.x] != 0;
+			};
+
+		// Falling lines can only reach a tile on the same minor row, so those are tried just in that case
+		int localDeltaX = abs(dominantDelta);
+		int localDeltaY = minorDelta * minorStep;
+		if (localDeltaY < 0)
+		{
+			continue;
+		}
+		if (CanSeeAlongRisingLines(IsLocalTileSolid, localDeltaX, localDeltaY))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool TileVisibilitySet::IsCenterLineClear(const std::vector<unsigned char>& solidTiles, const IntVec2& tileA, const IntVec2& tileB) const
+{
+	int tileX = tileA.x;
+	int tileY = tileA.y;
+	float deltaX = static_cast<float>(tileB.x - tileA.x);
+	float deltaY = static_cast<float>(tileB.y - tileA.y);
+	int stepX = (deltaX > 0.f) ? 1 : -1;
+	int stepY = (deltaY > 0.f) ? 1 : -1;
+
+	// Fraction of the line covered per tile crossed on each axis, the first crossing is half a tile away
+	float tPerX = (deltaX != 0.f) ? fabsf(1.f / deltaX) : 1e30f;
+	float tPerY = (deltaY != 0.f) ? fabsf(1.f / deltaY) : 1e30f;
+	float tNextX = 0.5f * tPerX;
+	float tNextY = 0.5f * tPerY;
+
+	while (tileX != tileB.x || tileY != tileB.y)
+	{
+		if (tNextX < tNextY)
+		{
+			tileX += stepX;
+			tNextX += tPerX;
+		}
+		else
+		{
+			tileY += stepY;
+			tNextY += tPerY;
+		}
+
+		if (tileX >= 0 && tileY >= 0 && tileX < m_dimensions.x && tileY < m_dimensions.y && solidTiles[tileX + tileY * m_dimensions.x] != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void TileVisibilitySet::SetBit(const IntVec2& fromTile, const IntVec2& toTile)
+{
+	int bitIndex = (toTile.x - fromTile.x + m_radius) + (toTile.y - fromTile.y + m_radius) * m_windowWidth;
+	uint64_t& word = m_bits[static_cast<size_t>(fromTile.x + fromTile.y * m_dimensions.x) * m_wordsPerTile + (bitIndex >> 6)];
+	word |= (1ull << (bitIndex & 63));
+}
+
+bool TileVisibilitySet::IsPotentiallyVisible(const IntVec2& fromTile, const IntVec2& toTile) const
+{
+	int offsetX = toTile.x - fromTile.x;
+	int offsetY = toTile.y - fromTile.y;
+	if (m_bits.empty() || abs(offsetX) > m_radius || abs(offsetY) > m_radius)
+	{
+		return true;
+	}
+	if (fromTile.x < 0 || fromTile.y < 0 || fromTile.x >= m_dimensions.x || fromTile.y >= m_dimensions.y)
+	{
+		return true;
+	}
+	if (toTile.x < 0 || toTile.y < 0 || toTile.x >= m_dimensions.x || toTile.y >= m_dimensions.y)
+	{
+		return true;
+	}
+
+	int bitIndex = (offsetX + m_radius) + (offsetY + m_radius) * m_windowWidth;
+	uint64_t word = m_bits[static_cast<size_t>(fromTile.x + fromTile.y * m_dimensions.x) * m_wordsPerTile + (bitIndex >> 6)];
+	return (word >> (bitIndex & 63)) & 1ull;
+}
+
+size_t TileVisibilitySet::GetMemoryBytes() const
+{
+	return sizeof(TileVisibilitySet) + m_bits.capacity() * sizeof(uint64_t);
+}
+
+int TileVisibilitySet::GetRadius() const
+{
+	return m_radius;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include <vector>
+#include <cstdint>
+
+// Potentially visible set for AI perception. Every tile stores a bitset of the tiles within a square
+// window around it that can be seen from it, so most failed sight checks never reach a raycast.
+// Tiles outside the window are reported visible; callers still do the exact distance and ray tests.
+class TileVisibilitySet
+{
+public:
+	TileVisibilitySet() = default;
+	~TileVisibilitySet() = default;
+
+	void Build(const IntVec2& dimensions, const std::vector<unsigned char>& solidTiles, int radius);
+	void RebuildAroundTile(const std::vector<unsigned char>& solidTiles, const IntVec2& tileCoords);
+	bool IsPotentiallyVisible(const IntVec2& fromTile, const IntVec2& toTile) const;
+
+	size_t GetMemoryBytes() const;
+	int GetRadius() const;
+
+private:
+	void BuildRowsInRegion(const std::vector<unsigned char>& solidTiles, const IntVec2& regionMins, const IntVec2& regionMaxs);
+	bool CanTilesSeeEachOther(const std::vector<unsigned char>& solidTiles, const IntVec2& tileA, const IntVec2& tileB) const;
+	bool IsCenterLineClear(const std::vector<unsigned char>& solidTiles, const IntVec2& tileA, const IntVec2& tileB) const;
+	void SetBit(const IntVec2& fromTile, const IntVec2& toTile);
+
+private:
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	int m_radius = 0;
+	int m_windowWidth = 0;
+	int m_wordsPerTile = 0;
+	std::vector<uint64_t> m_bits;
+};
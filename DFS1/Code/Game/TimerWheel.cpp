@@ -0,0 +1,356 @@
+#include "Game/TimerWheel.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+// Keeps a whole number of steps' worth of seconds from landing a tick short through rounding
+constexpr double TICK_EPSILON = 1e-6;
+
+void TimerWheel::Initialize(Map* map, float tickSeconds)
+{
+	m_map = map;
+	m_tickSeconds = tickSeconds > 0.f ? tickSeconds : 1.f / 60.f;
+	Clear();
+}
+
+void TimerWheel::Clear()
+{
+	m_timers.clear();
+	m_freeTimers.clear();
+	std::fill(std::begin(m_slotHeads), std::end(m_slotHeads), -1);
+	m_elapsedSeconds = 0.0;
+	m_currentTick = 0;
+	m_numPending = 0;
+	m_numExpiredLastAdvance = 0;
+	m_numCascadedLastAdvance = 0;
+}
+
+TimerHandle TimerWheel::Schedule(float delaySeconds, TimerCallback callback, const ActorUID& actorUID)
+{
+	int timerIndex = AllocateTimer(delaySeconds);
+	m_timers[timerIndex].m_callback = callback;
+	m_timers[timerIndex].m_actorUID = actorUID;
+	return TimerHandle{ timerIndex, m_timers[timerIndex].m_generation };
+}
+
+TimerHandle TimerWheel::ScheduleFlag(float delaySeconds, bool* flag, bool valueOnExpiry)
+{
+	int timerIndex = AllocateTimer(delaySeconds);
+	m_timers[timerIndex].m_flag = flag;
+	m_timers[timerIndex].m_flagValue = valueOnExpiry;
+	return TimerHandle{ timerIndex, m_timers[timerIndex].m_generation };
+}
+
+void TimerWheel::Cancel(TimerHandle& handle)
+{
+	if (IsPending(handle))
+	{
+		UnlinkTimer(handle.m_index);
+		FreeTimer(handle.m_index);
+	}
+	handle = TimerHandle();
+}
+
+bool TimerWheel::IsPending(const TimerHandle& handle) const
+{
+	if (handle.m_index < 0 || handle.m_index >= m_timers.size())
+	{
+		return false;
+	}
+	const Timer& timer = m_timers[handle.m_index];
+	return timer.m_slot >= 0 && timer.m_generation == handle.m_generation;
+}
+
+void TimerWheel::Advance(float deltaSeconds)
+{
+	m_numExpiredLastAdvance = 0;
+	m_numCascadedLastAdvance = 0;
+	m_elapsedSeconds += deltaSeconds;
+	unsigned long long targetTick = static_cast<unsigned long long>(std::floor(m_elapsedSeconds / m_tickSeconds + TICK_EPSILON));
+
+	while (m_currentTick < targetTick)
+	{
+		m_currentTick++;
+
+		// Each time a level comes all the way round, the next slot of the level above is spread out below
+		for (int level = 1; level < NUM_LEVELS; level++)
+		{
+			if ((m_currentTick & ((1ull << (SLOT_BITS * level)) - 1)) != 0)
+			{
+				break;
+			}
+			CascadeSlot(level, static_cast<int>((m_currentTick >> (SLOT_BITS * level)) & SLOT_MASK));
+		}
+		ExpireSlot(static_cast<int>(m_currentTick & SLOT_MASK));
+	}
+}
+
+double TimerWheel::GetElapsedSeconds() const
+{
+	return m_elapsedSeconds;
+}
+
+int TimerWheel::GetNumPending() const
+{
+	return m_numPending;
+}
+
+int TimerWheel::GetNumExpiredLastAdvance() const
+{
+	return m_numExpiredLastAdvance;
+}
+
+int TimerWheel::GetNumCascadedLastAdvance() const
+{
+	return m_numCascadedLastAdvance;
+}
+
+int TimerWheel::AllocateTimer(float delaySeconds)
+{
+	int timerIndex = static_cast<int>(m_timers.size());
+	if (!m_freeTimers.empty())
+	{
+		timerIndex = m_freeTimers.back();
+		m_freeTimers.pop_back();
+	}
+	else
+	{
+		m_timers.emplace_back();
+	}
+
+	// Rounded up to whole ticks so a timer never goes off early, and always at least one tick ahead
+	double expirySeconds = m_elapsedSeconds + std::max(0.f, delaySeconds);
+	unsigned long long expiryTick = static_cast<unsigned long long>(std::ceil(expirySeconds / m_tickSeconds - TICK_EPSILON));
+	unsigned long long maxTick = m_currentTick + (1ull << (SLOT_BITS * NUM_LEVELS)) - 1;
+	Timer& timer = m_timers[timerIndex];
+	timer.m_expiryTick = std::min(std::max(expiryTick, m_currentTick + 1), maxTick);
+	timer.m_callback = nullptr;
+	timer.m_actorUID = ActorUID::INVALID;
+	timer.m_flag = nullptr;
+	timer.m_flagValue = false;
+	InsertTimer(timerIndex);
+	m_numPending++;
+	return timerIndex;
+}
+
+void TimerWheel::FreeTimer(int timerIndex)
+{
+	Timer& timer = m_timers[timerIndex];
+	timer.m_slot = -1;
+	timer.m_generation++;
+	m_freeTimers.push_back(timerIndex);
+	m_numPending--;
+}
+
+void TimerWheel::InsertTimer(int timerIndex)
+{
+	// The level is picked by how far off the timer is, the slot within it by those bits of its expiry tick
+	Timer& timer = m_timers[timerIndex];
+	unsigned long long ticksAway = timer.m_expiryTick - m_currentTick;
+	int level = 0;
+	while (level < NUM_LEVELS - 1 && ticksAway >= (1ull << (SLOT_BITS * (level + 1))))
+	{
+		level++;
+	}
+	int slot = level * NUM_SLOTS + static_cast<int>((timer.m_expiryTick >> (SLOT_BITS * level)) & SLOT_MASK);
+
+	timer.m_slot = slot;
+	timer.m_previous = -1;
+	timer.m_next = m_slotHeads[slot];
+	if (timer.m_next >= 0)
+	{
+		m_timers[timer.m_next].m_previous = timerIndex;
+	}
+	m_slotHeads[slot] = timerIndex;
+}
+
+void TimerWheel::UnlinkTimer(int timerIndex)
+{
+	Timer& timer = m_timers[timerIndex];
+	if (timer.m_previous >= 0)
+	{
+		m_timers[timer.m_previous].m_next = timer.m_next;
+	}
+	else
+	{
+		m_slotHeads[timer.m_slot] = timer.m_next;
+	}
+	if (timer.m_next >= 0)
+	{
+		m_timers[timer.m_next].m_previous = timer.m_previous;
+	}
+}
+
+void TimerWheel::CascadeSlot(int level, int slotInLevel)
+{
+	int slot = level * NUM_SLOTS + slotInLevel;
+	int timerIndex = m_slotHeads[slot];
+	m_slotHeads[slot] = -1;
+	while (timerIndex >= 0)
+	{
+		int nextIndex = m_timers[timerIndex].m_next;
+		InsertTimer(timerIndex);
+		m_numCascadedLastAdvance++;
+		timerIndex = nextIndex;
+	}
+}
+
+void TimerWheel::ExpireSlot(int slotInLevel)
+{
+	// The slot is taken off the wheel first, anything scheduled from a callback always lands in a later slot
+	int timerIndex = m_slotHeads[slotInLevel];
+	m_slotHeads[slotInLevel] = -1;
+	while (timerIndex >= 0)
+	{
+		Timer expired = m_timers[timerIndex];
+		int nextIndex = expired.m_next;
+		FreeTimer(timerIndex);
+		m_numExpiredLastAdvance++;
+
+		if (expired.m_flag)
+		{
+			*expired.m_flag = expired.m_flagValue;
+		}
+		if (expired.m_callback)
+		{
+			expired.m_callback(m_map, expired.m_actorUID);
+		}
+		timerIndex = nextIndex;
+	}
+}
+
+STATIC void TimerWheel::RunValidation(std::vector<std::string>& outLines)
+{
+	// Random timers over an hour of play with uneven frame times, some cancelled, some set from inside the run.
+	// Each must fire once, never before its delay is up and never more than a tick after
+	constexpr int NUM_TIMERS = 20000;
+	constexpr float TICK_SECONDS = 1.f / 60.f;
+	RandomNumberGenerator rng;
+	TimerWheel wheel;
+	wheel.Initialize(nullptr, TICK_SECONDS);
+
+	std::unique_ptr<bool[]> hasFired(new bool[NUM_TIMERS]);
+	std::vector<double> dueSeconds(NUM_TIMERS);
+	std::vector<TimerHandle> handles(NUM_TIMERS);
+	std::vector<int> openTimers; // Neither fired nor cancelled yet
+	int numScheduled = 0;
+	int numCancelled = 0;
+	int numEarly = 0;
+	int numLate = 0;
+	int numCancelledFired = 0;
+	int maxPending = 0;
+
+	auto scheduleTimer = [&]()
+	{
+		// Mostly seconds away, with a tail reaching up past the second level of the wheel
+		float delaySeconds = rng.RollRandomFloatInRange(0.f, 1.f) < 0.9f ? rng.RollRandomFloatInRange(0.f, 10.f) : rng.RollRandomFloatInRange(10.f, 3000.f);
+		hasFired[numScheduled] = false;
+		dueSeconds[numScheduled] = wheel.GetElapsedSeconds() + delaySeconds;
+		handles[numScheduled] = wheel.ScheduleFlag(delaySeconds, &hasFired[numScheduled], true);
+		openTimers.push_back(numScheduled);
+		numScheduled++;
+	};
+
+	for (int timerIndex = 0; timerIndex < NUM_TIMERS / 2; timerIndex++)
+	{
+		scheduleTimer();
+	}
+
+	std::vector<int> cancelledTimers;
+	while (wheel.GetElapsedSeconds() < 3600.0)
+	{
+		double previousSeconds = wheel.GetElapsedSeconds();
+		wheel.Advance(rng.RollRandomFloatInRange(0.f, 1.f));
+		double nowSeconds = wheel.GetElapsedSeconds();
+		maxPending = std::max(maxPending, wheel.GetNumPending());
+
+		for (int openIndex = 0; openIndex < openTimers.size();)
+		{
+			int timerIndex = openTimers[openIndex];
+			bool isOverdue = nowSeconds > dueSeconds[timerIndex] + TICK_SECONDS + TICK_EPSILON;
+			if (hasFired[timerIndex])
+			{
+				numEarly += nowSeconds < dueSeconds[timerIndex] - TICK_EPSILON ? 1 : 0;
+				numLate += previousSeconds > dueSeconds[timerIndex] + TICK_SECONDS + TICK_EPSILON ? 1 : 0;
+			}
+			else if (isOverdue)
+			{
+				numLate++;
+			}
+			else
+			{
+				openIndex++;
+				continue;
+			}
+			openTimers[openIndex] = openTimers.back();
+			openTimers.pop_back();
+		}
+
+		if (numScheduled < NUM_TIMERS && rng.RollRandomFloatInRange(0.f, 1.f) < 0.5f)
+		{
+			scheduleTimer();
+		}
+		if (!openTimers.empty() && rng.RollRandomFloatInRange(0.f, 1.f) < 0.1f)
+		{
+			int openIndex = rng.SRollRandomIntInRange(0, static_cast<int>(openTimers.size()) - 1);
+			int timerIndex = openTimers[openIndex];
+			wheel.Cancel(handles[timerIndex]);
+			cancelledTimers.push_back(timerIndex);
+			numCancelled++;
+			openTimers[openIndex] = openTimers.back();
+			openTimers.pop_back();
+		}
+	}
+
+	for (int timerIndex : cancelledTimers)
+	{
+		numCancelledFired += hasFired[timerIndex] ? 1 : 0;
+	}
+	outLines.push_back(Stringf("Timer wheel: %d timers over an hour, %d cancelled, up to %d pending at once", numScheduled, numCancelled, maxPending));
+	outLines.push_back(Stringf("  %d fired early, %d fired late or not at all, %d cancelled ones fired", numEarly, numLate, numCancelledFired));
+
+	// Per step cost with thousands of agents each holding a long timer, against counting every one down
+	constexpr int NUM_AGENT_TIMERS = 10000;
+	constexpr int NUM_STEPS = 600;
+	TimerWheel agentWheel;
+	agentWheel.Initialize(nullptr, TICK_SECONDS);
+	std::unique_ptr<bool[]> agentFlags(new bool[NUM_AGENT_TIMERS]);
+	std::vector<float> countdowns(NUM_AGENT_TIMERS);
+	for (int agentIndex = 0; agentIndex < NUM_AGENT_TIMERS; agentIndex++)
+	{
+		countdowns[agentIndex] = rng.RollRandomFloatInRange(1.f, 30.f);
+		agentFlags[agentIndex] = false;
+		agentWheel.ScheduleFlag(countdowns[agentIndex], &agentFlags[agentIndex], true);
+	}
+
+	auto wheelStart = std::chrono::high_resolution_clock::now();
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		agentWheel.Advance(TICK_SECONDS);
+	}
+	auto wheelEnd = std::chrono::high_resolution_clock::now();
+
+	int numCountdownsExpired = 0;
+	auto countdownStart = std::chrono::high_resolution_clock::now();
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		for (float& countdown : countdowns)
+		{
+			countdown -= TICK_SECONDS;
+			if (countdown <= 0.f && countdown > -TICK_SECONDS)
+			{
+				numCountdownsExpired++;
+			}
+		}
+	}
+	auto countdownEnd = std::chrono::high_resolution_clock::now();
+
+	float wheelStepUS = std::chrono::duration<float, std::micro>(wheelEnd - wheelStart).count() / static_cast<float>(NUM_STEPS);
+	float countdownStepUS = std::chrono::duration<float, std::micro>(countdownEnd - countdownStart).count() / static_cast<float>(NUM_STEPS);
+	int numWheelExpired = static_cast<int>(std::count(agentFlags.get(), agentFlags.get() + NUM_AGENT_TIMERS, true));
+	outLines.push_back(Stringf("  %d agent timers over %d steps: wheel %.3f us a step, countdowns %.3f us a step, %d and %d expired", NUM_AGENT_TIMERS, NUM_STEPS, wheelStepUS, countdownStepUS, numWheelExpired, numCountdownsExpired));
+}
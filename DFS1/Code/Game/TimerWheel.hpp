@@ -0,0 +1,81 @@
+#pragma once
+#include "Game/ActorUID.hpp"
+#include <vector>
+#include <string>
+
+class Map;
+
+typedef void (*TimerCallback)(Map* map, const ActorUID& actorUID);
+
+struct TimerHandle
+{
+	int m_index = -1;
+	unsigned int m_generation = 0;
+};
+
+// Gameplay timers for one map on a hierarchical timing wheel. Time moves in ticks of one simulation step; a timer
+// sits in a slot of the level matching how far off it is and only drops a level when its slot comes round, so
+// advancing costs the timers that expire plus the few moved down, however many are waiting. On expiry a timer
+// either calls back with the actor it was set for, looked up again by the callback, or writes a value into a flag.
+// Not thread safe: timers are only set and advanced while nothing else touches the map, never from parallel think.
+class TimerWheel
+{
+public:
+	TimerWheel() = default;
+	~TimerWheel() = default;
+
+	void Initialize(Map* map, float tickSeconds);
+	void Clear();
+
+	TimerHandle Schedule(float delaySeconds, TimerCallback callback, const ActorUID& actorUID);
+	TimerHandle ScheduleFlag(float delaySeconds, bool* flag, bool valueOnExpiry);
+	void Cancel(TimerHandle& handle);
+	bool IsPending(const TimerHandle& handle) const;
+
+	void Advance(float deltaSeconds);
+	double GetElapsedSeconds() const; // Simulation time since the map started, what deadlines are measured against
+
+	int GetNumPending() const;
+	int GetNumExpiredLastAdvance() const;
+	int GetNumCascadedLastAdvance() const;
+
+	static void RunValidation(std::vector<std::string>& outLines);
+
+private:
+	static constexpr int SLOT_BITS = 6;
+	static constexpr int NUM_SLOTS = 1 << SLOT_BITS;
+	static constexpr int SLOT_MASK = NUM_SLOTS - 1;
+	static constexpr int NUM_LEVELS = 4; // 2^24 ticks, over three days at 60 steps a second
+
+	struct Timer
+	{
+		unsigned long long m_expiryTick = 0;
+		int m_slot = -1; // -1 while free
+		int m_previous = -1;
+		int m_next = -1;
+		unsigned int m_generation = 0;
+		TimerCallback m_callback = nullptr;
+		ActorUID m_actorUID = ActorUID::INVALID;
+		bool* m_flag = nullptr;
+		bool m_flagValue = false;
+	};
+
+	int AllocateTimer(float delaySeconds);
+	void FreeTimer(int timerIndex);
+	void InsertTimer(int timerIndex);
+	void UnlinkTimer(int timerIndex);
+	void CascadeSlot(int level, int slotInLevel);
+	void ExpireSlot(int slotInLevel);
+
+private:
+	Map* m_map = nullptr;
+	float m_tickSeconds = 1.f / 60.f;
+	double m_elapsedSeconds = 0.0;
+	unsigned long long m_currentTick = 0;
+	std::vector<Timer> m_timers;
+	std::vector<int> m_freeTimers;
+	int m_slotHeads[NUM_LEVELS * NUM_SLOTS];
+	int m_numPending = 0;
+	int m_numExpiredLastAdvance = 0;
+	int m_numCascadedLastAdvance = 0;
+};
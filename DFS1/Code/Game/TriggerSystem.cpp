@@ -0,0 +1,196 @@
+#include "Game/TriggerSystem.hpp"
+#include "Game/Map.hpp"
+#include "Game/Actor.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+
+void TriggerSystem::Initialize(const IntVec2& mapDimensions)
+{
+	m_dimensions = IntVec2(std::max(mapDimensions.x, 1), std::max(mapDimensions.y, 1));
+	Clear();
+}
+
+void TriggerSystem::Clear()
+{
+	m_triggers.clear();
+	m_freeTriggers.clear();
+	m_tileTriggers.clear();
+	m_tileTriggers.resize(static_cast<size_t>(m_dimensions.x) * m_dimensions.y);
+	m_subscribers.clear();
+	m_testStamp = 0;
+	m_numActiveTriggers = 0;
+	m_numMovedLastUpdate = 0;
+	m_numTestedLastUpdate = 0;
+}
+
+int TriggerSystem::AddTrigger(const Vec2& center, float radius, const FloatRange& heightRange, const ActorUID& ownerUID)
+{
+	int triggerIndex = static_cast<int>(m_triggers.size());
+	if (!m_freeTriggers.empty())
+	{
+		triggerIndex = m_freeTriggers.back();
+		m_freeTriggers.pop_back();
+	}
+	else
+	{
+		m_triggers.emplace_back();
+	}
+
+	Trigger& trigger = m_triggers[triggerIndex];
+	trigger.m_center = center;
+	trigger.m_radius = radius;
+	trigger.m_heightRange = heightRange;
+	trigger.m_ownerUID = ownerUID;
+	trigger.m_isActive = true;
+	trigger.m_lastTestedStamp = 0;
+
+	IntVec2 tileMins;
+	IntVec2 tileMaxs;
+	GetTileBounds(center, radius, tileMins, tileMaxs);
+	for (int tileY = tileMins.y; tileY <= tileMaxs.y; tileY++)
+	{
+		for (int tileX = tileMins.x; tileX <= tileMaxs.x; tileX++)
+		{
+			m_tileTriggers[tileX + tileY * m_dimensions.x].push_back(triggerIndex);
+		}
+	}
+	m_numActiveTriggers++;
+	return triggerIndex;
+}
+
+void TriggerSystem::RemoveTrigger(int triggerIndex)
+{
+	if (triggerIndex < 0 || triggerIndex >= m_triggers.size() || !m_triggers[triggerIndex].m_isActive)
+	{
+		return;
+	}
+
+	Trigger& trigger = m_triggers[triggerIndex];
+	IntVec2 tileMins;
+	IntVec2 tileMaxs;
+	GetTileBounds(trigger.m_center, trigger.m_radius, tileMins, tileMaxs);
+	for (int tileY = tileMins.y; tileY <= tileMaxs.y; tileY++)
+	{
+		for (int tileX = tileMins.x; tileX <= tileMaxs.x; tileX++)
+		{
+			std::vector<int>& tile = m_tileTriggers[tileX + tileY * m_dimensions.x];
+			tile.erase(std::remove(tile.begin(), tile.end(), triggerIndex), tile.end());
+		}
+	}
+
+	trigger.m_isActive = false;
+	trigger.m_ownerUID = ActorUID::INVALID;
+	m_freeTriggers.push_back(triggerIndex);
+	m_numActiveTriggers--;
+}
+
+bool TriggerSystem::IsAnyTriggerCenteredAt(const Vec2& position) const
+{
+	int tileX = std::clamp(RoundDownToInt(position.x), 0, m_dimensions.x - 1);
+	int tileY = std::clamp(RoundDownToInt(position.y), 0, m_dimensions.y - 1);
+	for (int triggerIndex : m_tileTriggers[tileX + tileY * m_dimensions.x])
+	{
+		if (m_triggers[triggerIndex].m_center == position)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void TriggerSystem::Subscribe(const ActorUID& actorUID)
+{
+	Subscriber subscriber;
+	subscriber.m_actorUID = actorUID;
+	m_subscribers.push_back(subscriber);
+}
+
+void TriggerSystem::Update(const Map& map, std::vector<TriggerHit>& outHits)
+{
+	outHits.clear();
+	m_numMovedLastUpdate = 0;
+	m_numTestedLastUpdate = 0;
+
+	for (int subscriberIndex = 0; subscriberIndex < m_subscribers.size();)
+	{
+		Subscriber& subscriber = m_subscribers[subscriberIndex];
+		Actor* actor = map.GetActorByUID(subscriber.m_actorUID);
+		if (actor == nullptr)
+		{
+			// Its actor is gone, the last subscriber takes its place and is looked at next
+			subscriber = m_subscribers.back();
+			m_subscribers.pop_back();
+			continue;
+		}
+		subscriberIndex++;
+
+		if (subscriber.m_hasBeenTested && actor->m_position == subscriber.m_lastTestedPosition)
+		{
+			continue;
+		}
+		subscriber.m_lastTestedPosition = actor->m_position;
+		subscriber.m_hasBeenTested = true;
+		m_numMovedLastUpdate++;
+		m_testStamp++;
+
+		Vec2 actorCenter(actor->m_position.x, actor->m_position.y);
+		FloatRange actorHeightRange(actor->m_position.z, actor->m_position.z + actor->m_physicsHeight);
+		IntVec2 tileMins;
+		IntVec2 tileMaxs;
+		GetTileBounds(actorCenter, actor->m_physicsRadius, tileMins, tileMaxs);
+		for (int tileY = tileMins.y; tileY <= tileMaxs.y; tileY++)
+		{
+			for (int tileX = tileMins.x; tileX <= tileMaxs.x; tileX++)
+			{
+				for (int triggerIndex : m_tileTriggers[tileX + tileY * m_dimensions.x])
+				{
+					Trigger& trigger = m_triggers[triggerIndex];
+					if (trigger.m_lastTestedStamp == m_testStamp)
+					{
+						continue;
+					}
+					trigger.m_lastTestedStamp = m_testStamp;
+					m_numTestedLastUpdate++;
+
+					if (trigger.m_heightRange.IsOverlapingWith(actorHeightRange) && DoDiscsOverlap(actorCenter, actor->m_physicsRadius, trigger.m_center, trigger.m_radius))
+					{
+						TriggerHit hit;
+						hit.m_triggerIndex = triggerIndex;
+						hit.m_ownerUID = trigger.m_ownerUID;
+						hit.m_visitorUID = subscriber.m_actorUID;
+						outHits.push_back(hit);
+					}
+				}
+			}
+		}
+	}
+}
+
+int TriggerSystem::GetNumActiveTriggers() const
+{
+	return m_numActiveTriggers;
+}
+
+int TriggerSystem::GetNumSubscribers() const
+{
+	return static_cast<int>(m_subscribers.size());
+}
+
+int TriggerSystem::GetNumMovedLastUpdate() const
+{
+	return m_numMovedLastUpdate;
+}
+
+int TriggerSystem::GetNumTestedLastUpdate() const
+{
+	return m_numTestedLastUpdate;
+}
+
+void TriggerSystem::GetTileBounds(const Vec2& center, float radius, IntVec2& outMins, IntVec2& outMaxs) const
+{
+	// Anything off the map is kept in the nearest edge tile
+	outMins.x = std::clamp(RoundDownToInt(center.x - radius), 0, m_dimensions.x - 1);
+	outMins.y = std::clamp(RoundDownToInt(center.y - radius), 0, m_dimensions.y - 1);
+	outMaxs.x = std::clamp(RoundDownToInt(center.x + radius), 0, m_dimensions.x - 1);
+	outMaxs.y = std::clamp(RoundDownToInt(center.y + radius), 0, m_dimensions.y - 1);
+}
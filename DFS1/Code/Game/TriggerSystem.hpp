@@ -0,0 +1,73 @@
+#pragma once
+#include "Game/ActorUID.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/FloatRange.hpp"
+#include <vector>
+
+class Map;
+
+struct TriggerHit
+{
+	int m_triggerIndex = -1;
+	ActorUID m_ownerUID = ActorUID::INVALID;
+	ActorUID m_visitorUID = ActorUID::INVALID;
+};
+
+// Static trigger volumes, upright cylinders, listed in a table by the tiles they cover. Nothing is tested unless
+// a subscribed actor has moved, and then only the volumes listed in the tiles under it, so volumes that nobody
+// is near cost nothing. A volume reports a hit every time a subscriber moves while overlapping it, whoever
+// handles the hit removes it if it should only fire once.
+class TriggerSystem
+{
+public:
+	TriggerSystem() = default;
+	~TriggerSystem() = default;
+
+	void Initialize(const IntVec2& mapDimensions);
+	void Clear();
+
+	int AddTrigger(const Vec2& center, float radius, const FloatRange& heightRange, const ActorUID& ownerUID);
+	void RemoveTrigger(int triggerIndex);
+	bool IsAnyTriggerCenteredAt(const Vec2& position) const;
+
+	void Subscribe(const ActorUID& actorUID);
+	void Update(const Map& map, std::vector<TriggerHit>& outHits);
+
+	int GetNumActiveTriggers() const;
+	int GetNumSubscribers() const;
+	int GetNumMovedLastUpdate() const;
+	int GetNumTestedLastUpdate() const;
+
+private:
+	struct Trigger
+	{
+		Vec2 m_center;
+		float m_radius = 0.f;
+		FloatRange m_heightRange;
+		ActorUID m_ownerUID = ActorUID::INVALID;
+		bool m_isActive = false;
+		unsigned int m_lastTestedStamp = 0;
+	};
+
+	struct Subscriber
+	{
+		ActorUID m_actorUID = ActorUID::INVALID;
+		Vec3 m_lastTestedPosition;
+		bool m_hasBeenTested = false;
+	};
+
+	void GetTileBounds(const Vec2& center, float radius, IntVec2& outMins, IntVec2& outMaxs) const;
+
+private:
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	std::vector<Trigger> m_triggers;
+	std::vector<int> m_freeTriggers;
+	std::vector<std::vector<int>> m_tileTriggers;
+	std::vector<Subscriber> m_subscribers;
+	unsigned int m_testStamp = 0; // Keeps a volume listed in several tiles from being tested twice per subscriber
+	int m_numActiveTriggers = 0;
+	int m_numMovedLastUpdate = 0;
+	int m_numTestedLastUpdate = 0;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+
+// Hands whole values from one writer thread to one reader thread without locks. The writer fills its own
+// buffer and publishes it, the reader picks up whatever was published last. Neither side ever waits on the
+// other: the third buffer is the one sitting between them, swapped in and out with a single exchange.
+template <typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() = default;
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// Writer side
+	T& GetWriteBuffer()
+	{
+		return m_buffers[m_writeIndex];
+	}
+
+	void Publish()
+	{
+		int previousReady = m_readyIndex.exchange(m_writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+		m_writeIndex = previousReady & INDEX_MASK;
+	}
+
+	// Reader side. Returns true when a newer buffer was published since the last call
+	bool AcquireLatest()
+	{
+		if ((m_readyIndex.load(std::memory_order_relaxed) & FRESH_BIT) == 0)
+		{
+			return false;
+		}
+		int previousReady = m_readyIndex.exchange(m_readIndex, std::memory_order_acq_rel);
+		m_readIndex = previousReady & INDEX_MASK;
+		return true;
+	}
+
+	const T& GetReadBuffer() const
+	{
+		return m_buffers[m_readIndex];
+	}
+
+private:
+	static constexpr int INDEX_MASK = 3;
+	static constexpr int FRESH_BIT = 4;
+
+	T m_buffers[3];
+	int m_writeIndex = 0;
+	int m_readIndex = 1;
+	std::atomic<int> m_readyIndex{ 2 };
+};
@@ -0,0 +1,111 @@
+#include "Game/WallDistanceField.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <algorithm>
+
+constexpr int MAX_WALL_DISTANCE = 255;
+
+void WallDistanceField::Build(const IntVec2& dimensions, const std::vector<unsigned char>& solidTiles)
+{
+	m_dimensions = dimensions;
+	m_distances.assign(static_cast<size_t>(dimensions.x) * static_cast<size_t>(dimensions.y), 0);
+	PropagateInRegion(solidTiles, IntVec2::ZERO, dimensions - IntVec2(1, 1));
+}
+
+void WallDistanceField::UpdateAroundTile(const std::vector<unsigned char>& solidTiles, const IntVec2& tileCoords)
+{
+	// Distances change by at most one between neighbors, so once a ring around the edited tile holds no distance
+	// reaching the ring's radius, nothing on or past that ring could have measured its distance through this tile
+	int radius = 1;
+	for (; radius <= MAX_WALL_DISTANCE; radius++)
+	{
+		bool isRingAffected = false;
+		for (int tileY = tileCoords.y - radius; tileY <= tileCoords.y + radius && !isRingAffected; tileY++)
+		{
+			int stepX = (tileY == tileCoords.y - radius || tileY == tileCoords.y + radius) ? 1 : radius * 2;
+			for (int tileX = tileCoords.x - radius; tileX <= tileCoords.x + radius; tileX += stepX)
+			{
+				if (GetStoredDistance(tileX, tileY, 0) >= radius)
+				{
+					isRingAffected = true;
+					break;
+				}
+			}
+		}
+
+		if (!isRingAffected)
+		{
+			break;
+		}
+	}
+
+	IntVec2 regionMins = IntVec2(std::max(tileCoords.x - radius + 1, 0), std::max(tileCoords.y - radius + 1, 0));
+	IntVec2 regionMaxs = IntVec2(std::min(tileCoords.x + radius - 1, m_dimensions.x - 1), std::min(tileCoords.y + radius - 1, m_dimensions.y - 1));
+	PropagateInRegion(solidTiles, regionMins, regionMaxs);
+
+#if defined(_DEBUG)
+	WallDistanceField rebuiltField;
+	rebuiltField.Build(m_dimensions, solidTiles);
+	GUARANTEE_OR_DIE(rebuiltField.m_distances == m_distances, "Wall distance field update does not match a full rebuild");
+#endif
+}
+
+int WallDistanceField::GetDistance(int tileX, int tileY) const
+{
+	// Nothing is skipped outside the map
+	return GetStoredDistance(tileX, tileY, 0);
+}
+
+size_t WallDistanceField::GetMemoryBytes() const
+{
+	return sizeof(WallDistanceField) + m_distances.capacity() * sizeof(unsigned char);
+}
+
+void WallDistanceField::PropagateInRegion(const std::vector<unsigned char>& solidTiles, const IntVec2& regionMins, const IntVec2& regionMaxs)
+{
+	for (int tileY = regionMins.y; tileY <= regionMaxs.y; tileY++)
+	{
+		for (int tileX = regionMins.x; tileX <= regionMaxs.x; tileX++)
+		{
+			int tileIndex = tileX + tileY * m_dimensions.x;
+			m_distances[tileIndex] = solidTiles[tileIndex] ? 0 : MAX_WALL_DISTANCE;
+		}
+	}
+
+	// Two raster passes of the 3x3 chessboard mask. Tiles just outside the region keep their values and seed it
+	for (int tileY = regionMins.y; tileY <= regionMaxs.y; tileY++)
+	{
+		for (int tileX = regionMins.x; tileX <= regionMaxs.x; tileX++)
+		{
+			int tileIndex = tileX + tileY * m_dimensions.x;
+			int distance = m_distances[tileIndex];
+			distance = std::min(distance, GetStoredDistance(tileX - 1, tileY, MAX_WALL_DISTANCE) + 1);
+			distance = std::min(distance, GetStoredDistance(tileX - 1, tileY - 1, MAX_WALL_DISTANCE) + 1);
+			distance = std::min(distance, GetStoredDistance(tileX, tileY - 1, MAX_WALL_DISTANCE) + 1);
+			distance = std::min(distance, GetStoredDistance(tileX + 1, tileY - 1, MAX_WALL_DISTANCE) + 1);
+			m_distances[tileIndex] = static_cast<unsigned char>(distance);
+		}
+	}
+
+	for (int tileY = regionMaxs.y; tileY >= regionMins.y; tileY--)
+	{
+		for (int tileX = regionMaxs.x; tileX >= regionMins.x; tileX--)
+		{
+			int tileIndex = tileX + tileY * m_dimensions.x;
+			int distance = m_distances[tileIndex];
+			distance = std::min(distance, GetStoredDistance(tileX + 1, tileY, MAX_WALL_DISTANCE) + 1);
+			distance = std::min(distance, GetStoredDistance(tileX + 1, tileY + 1, MAX_WALL_DISTANCE) + 1);
+			distance = std::min(distance, GetStoredDistance(tileX, tileY + 1, MAX_WALL_DISTANCE) + 1);
+			distance = std::min(distance, GetStoredDistance(tileX - 1, tileY + 1, MAX_WALL_DISTANCE) + 1);
+			m_distances[tileIndex] = static_cast<unsigned char>(distance);
+		}
+	}
+}
+
+int WallDistanceField::GetStoredDistance(int tileX, int tileY, int outOfBoundsDistance) const
+{
+	if (tileX < 0 || tileY < 0 || tileX >= m_dimensions.x || tileY >= m_dimensions.y)
+	{
+		return outOfBoundsDistance;
+	}
+	return m_distances[tileX + tileY * m_dimensions.x];
+}
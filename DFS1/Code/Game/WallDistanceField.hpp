@@ -0,0 +1,27 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include <vector>
+
+// Chebyshev distance from every tile to the nearest solid tile, capped at 255. Any tile closer to a tile
+// than that tile's wall distance cannot be solid, which lets SweptDiscCollision rule out most moves without a tile walk.
+// Tiles outside the map are treated as open.
+class WallDistanceField
+{
+public:
+	WallDistanceField() = default;
+	~WallDistanceField() = default;
+
+	void Build(const IntVec2& dimensions, const std::vector<unsigned char>& solidTiles);
+	void UpdateAroundTile(const std::vector<unsigned char>& solidTiles, const IntVec2& tileCoords);
+	int GetDistance(int tileX, int tileY) const;
+
+	size_t GetMemoryBytes() const;
+
+private:
+	void PropagateInRegion(const std::vector<unsigned char>& solidTiles, const IntVec2& regionMins, const IntVec2& regionMaxs);
+	int GetStoredDistance(int tileX, int tileY, int outOfBoundsDistance) const;
+
+private:
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	std::vector<unsigned char> m_distances;
+};
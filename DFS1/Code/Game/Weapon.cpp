@@ -17,7 +17,7 @@ Weapon::Weapon(const WeaponDefinition& weaponInfo, Actor* actor)
 {
 	m_actor = actor;
 	m_weaponDefName = weaponInfo.m_name;
-	m_refireTime = weaponInfo.m_refireTime;
+	m_nextFireSeconds = m_actor->m_map->m_timers.GetElapsedSeconds() + weaponInfo.m_refireTime;
 
 	// Enemy Melee
 	m_enemyMeleeCount = weaponInfo.m_enemyMeleeCount;
@@ -40,7 +40,8 @@ std::string Weapon::GetCurrentWeaponDefName() const
 
 void Weapon::Fire()
 {
-	if (m_refireTime <= 0.f)
+	double nowSeconds = m_actor->m_map->m_timers.GetElapsedSeconds();
+	if (nowSeconds >= m_nextFireSeconds)
 	{
 		if (m_weaponDefName == "EnemyMelee")
 		{
@@ -57,15 +58,10 @@ void Weapon::Fire()
 				}
 			}
 		}
-		m_refireTime = m_weaponDefinition->m_refireTime;
+		m_nextFireSeconds = nowSeconds + m_weaponDefinition->m_refireTime;
 	}
 }
 
-void Weapon::Update()
-{
-	m_refireTime -= g_theApp->m_game->m_clock->GetDeltaSeconds();
-}
-
 Vec3 Weapon::GetRandomDirectionInCone(float spreadDegrees) const
 {
 	EulerAngles result;
@@ -23,7 +23,6 @@ public:
 public:
 	std::string GetCurrentWeaponDefName() const;
 	void Fire();
-	void Update();
 	Vec3 GetRandomDirectionInCone(float spreadDegrees) const;
 
 public:
@@ -32,7 +31,7 @@ public:
 	Actor* m_actor = nullptr;
 
 	std::string m_weaponDefName = "";
-	float m_refireTime = 0.f;
+	double m_nextFireSeconds = 0.0; // On the map's timer wheel clock
 
 	// Enemy Melee
 	int m_enemyMeleeCount = 0;